@@ -0,0 +1,384 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "./include/Matrix.h"
+#include "global.h"
+#include "SAT_Const.h"
+#include "Legendre.h"
+#include "AccelHarmonic.h"
+#include "AccelPointMass.h"
+#include "GravityGrid.h"
+#include "AccelDrag.h"
+#include "AccelSolrad.h"
+#include "AccelBatch.h"
+#include "JPL_Eph_DE430.h"
+#include "Mjday_TDB.h"
+#include "IERS.h"
+#include "NutMatrix.h"
+#include "Accel.h"
+#include "VarEqn.h"
+#include "DEInteg.h"
+#include "RKInteg.h"
+#include "EKF_GEOS3.h"
+
+/*%--------------------------------------------------------------------------
+%
+% Benchmark: Micro and macro benchmarks of the orbit determination code
+%
+% Every benchmark is repeated, doubling the number of iterations, until a
+% batch lasts at least min_time seconds. It reports the time per call, the
+% heap allocations per call (global operator new is counted) and the
+% throughput in calls (or items) per second.
+%
+% Usage (from the build directory, the data files are read from ../data;
+% configure with -DCMAKE_BUILD_TYPE=Release for meaningful timings):
+%   Proyecto_bench [--min_time=<s>] [filter]
+%
+% Only the benchmarks whose name contains the filter are run. The ones
+% that need data/DE430Coeff.txt are skipped if the file is not present.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file Benchmark.cpp
+ * @brief Programa de medida de tiempos, reservas de memoria y rendimiento.
+ */
+
+static std::atomic<unsigned long long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+static double min_time = 0.5;
+static const char* filter = "";
+static volatile double sink;
+
+/**
+ * @brief Evita que el compilador elimine el cálculo medido.
+ */
+static void Use(double x) {
+    sink = x;
+}
+
+/**
+ * @brief Ejecuta y mide un caso.
+ *
+ * @param name Nombre del caso.
+ * @param f Invocable que realiza una llamada.
+ * @param items Elementos procesados por llamada (para el rendimiento).
+ * @param max_iter Límite de iteraciones por lote (1 para los casos largos).
+ */
+template <class F>
+static void Bench(const char* name, F&& f, double items = 1.0, long max_iter = 1L << 30) {
+    if (strstr(name, filter) == nullptr) {
+        return;
+    }
+
+    //% Warm-up call (first touch of the data, lazy initialisation)
+    f();
+
+    long iter = 1;
+    double sec;
+    unsigned long long nalloc;
+    for (;;) {
+        unsigned long long a0 = allocations.load();
+        auto t0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < iter; i++) {
+            f();
+        }
+        sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        nalloc = allocations.load() - a0;
+        if (sec >= min_time || iter >= max_iter) {
+            break;
+        }
+        iter *= 2;
+    }
+
+    double per = sec/iter;
+    const char* unit = "s";
+    double scale = 1.0;
+    if (per < 1e-6) {
+        unit = "ns"; scale = 1e9;
+    } else if (per < 1e-3) {
+        unit = "us"; scale = 1e6;
+    } else if (per < 1.0) {
+        unit = "ms"; scale = 1e3;
+    }
+    printf("%-32s%12.3f %-2s%12ld%14.1f%14.4g/s\n", name, per*scale, unit, iter,
+           (double) nalloc/iter, items*iter/sec);
+    fflush(stdout);
+}
+
+/**
+ * @brief Comprueba si existe un fichero de datos.
+ */
+static bool Exists(const char* path) {
+    FILE* fid = fopen(path, "r");
+    if (fid == nullptr) {
+        return false;
+    }
+    fclose(fid);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--min_time=", 11) == 0) {
+            min_time = atof(argv[i] + 11);
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    global::eop19620101();
+    global::GGM03S();
+    global::AuxParam();
+    global::n = 20;
+    global::m = 20;
+    global::Mjd_UTC = 4.974611128472211e+04;
+    global::Mjd_TT = 4.974611706231468e+04;
+    bool jpl = Exists("../data/DE430Coeff.txt");
+    if (jpl) {
+        global::DE430Coeff();
+    }
+
+    printf("%-32s%15s%12s%14s%16s\n", "Benchmark", "Time", "Iterations", "Allocs/call", "Throughput");
+    printf("%s\n", std::string(90, '-').c_str());
+
+    double Y[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                   4645.04725161806, -2752.21591588204, -7507.99940987031};
+    Matrix E = Matrix::identity(3);
+
+    //% Legendre functions and harmonic gravity field
+    const int degree[4] = {2, 20, 70, 180};
+    char name[64];
+    for (int k = 0; k < 4; k++) {
+        int n = degree[k];
+        Matrix pnm(n+1, n+1), dpnm(n+1, n+1);
+        snprintf(name, sizeof(name), "Legendre/%d", n);
+        Bench(name, [&]() { Legendre(n, n, 0.5, pnm, dpnm); Use(pnm(n+1,n+1)); });
+        snprintf(name, sizeof(name), "AccelHarmonic/%d", n);
+        Bench(name, [&]() {
+            double* a = AccelHarmonic(Y, E, n, n);
+            Use(a[0]);
+            delete[] a;
+        });
+        snprintf(name, sizeof(name), "AccelHarmonic/%d/noalloc", n);
+        Bench(name, [&]() {
+            double a[3];
+            AccelHarmonic(Y, E, n, n, a);
+            Use(a[0]);
+        });
+    }
+
+    //% Batched harmonic kernels, double and mixed precision (64 states)
+    const int NB = 64;
+    double rb[3*NB], ab[3*NB];
+    for (int k = 0; k < NB; k++) {
+        rb[3*k] = 7000e3*cos(0.1*k);
+        rb[3*k+1] = 6900e3*sin(0.1*k);
+        rb[3*k+2] = 100e3*(k-32);
+    }
+    for (int k = 1; k < 4; k++) {
+        int n = degree[k];
+        snprintf(name, sizeof(name), "AccelHarmonicBatch/%dx%d", n, NB);
+        Bench(name, [&]() { AccelHarmonicBatch(NB, rb, E, n, n, ab); Use(ab[0]); }, NB);
+        snprintf(name, sizeof(name), "AccelHarmonicMixed/%dx%d", n, NB);
+        Bench(name, [&]() { AccelHarmonicMixed(NB, rb, E, n, n, ab); Use(ab[0]); }, NB);
+    }
+
+    //% Tabulated field (degree 20, 1 deg grid, 6800-7200 km)
+    if (strstr("GravityGrid/20", filter) != nullptr) {
+        GravityGrid grid(20, 20, 6800e3, 7200e3, 11, 181, 360);
+        double rg[3] = {6000e3, 3000e3, 1500e3};
+        Bench("GravityGrid/20", [&]() {
+            double a[3];
+            grid.accel(rg, E, a);
+            Use(a[0]);
+        });
+    }
+
+    //% Third-body perturbations: ten bodies, one call each or one batched call
+    double sb[10][3];
+    PointMasses bodies;
+    for (int j = 0; j < 10; j++) {
+        sb[j][0] = 1e9*(j+1);
+        sb[j][1] = -2e8*j;
+        sb[j][2] = 5e8;
+        bodies.add(sb[j], GM_Moon);
+    }
+    Bench("AccelPointMass/10x1", [&]() {
+        double s = 0.0;
+        for (int j = 0; j < 10; j++) {
+            double* a = AccelPointMass(Y, sb[j], GM_Moon);
+            s += a[0];
+            delete[] a;
+        }
+        Use(s);
+    });
+    Bench("AccelPointMass/batch", [&]() {
+        double a[3] = {0.0, 0.0, 0.0};
+        AccelPointMass(bodies, 1, Y, a);
+        Use(a[0]);
+    });
+
+    //% Atmospheric drag (Harris-Priester), to compare with AccelHarmonic/20
+    HarrisPriester hp;
+    double sun[3] = {1.4e11, -2.0e10, 8.0e9};
+    double rd[3] = {6000e3, 3000e3, 1500e3};
+    Bench("AccelDrag/HarrisPriester", [&]() {
+        double a[3] = {0.0, 0.0, 0.0};
+        AccelDrag(hp, global::Mjd_TT, rd, &Y[3], sun, E, 10.0, 1000.0, 2.2, a);
+        Use(a[0]);
+    });
+
+    //% Earth shadow and solar radiation pressure
+    Bench("Shadow/conical", [&]() { Use(Shadow(rd, sun, SHADOW_CONICAL)); });
+    Bench("AccelSolrad", [&]() {
+        double a[3] = {0.0, 0.0, 0.0};
+        AccelSolrad(rd, sun, 10.0, 1000.0, 1.3, Shadow(rd, sun, SHADOW_SMOOTH, 3.0), a);
+        Use(a[0]);
+    });
+
+    //% DEInteg and RKInteg on the same arc (gravity field only, no ephemerides)
+    AccelParam pg = GlobalAccelParam();
+    pg.sun = 0;
+    pg.moon = 0;
+    pg.planets = 0;
+    auto fg = [&pg](double x, const double* y, double* dy) { Accel(x, y, dy, pg); };
+    Bench("Integ/DEInteg/3600s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        DEInteg(fg, 0, 3600.0, 1e-13, 1e-6, 6, Z);
+        Use(Z[0]);
+    }, 1.0, 1);
+    Bench("Integ/RKInteg/3600s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        RKInteg(fg, 0, 3600.0, 1e-13, 1e-6, 6, Z);
+        Use(Z[0]);
+    }, 1.0, 1);
+    Bench("Integ/DEInteg/60x60s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        for (int k = 0; k < 60; k++) {
+            DEInteg(fg, 60.0*k, 60.0*(k+1), 1e-13, 1e-6, 6, Z);
+        }
+        Use(Z[0]);
+    }, 1.0, 1);
+    Bench("Integ/RKInteg/60x60s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        for (int k = 0; k < 60; k++) {
+            RKInteg(fg, 60.0*k, 60.0*(k+1), 1e-13, 1e-6, 6, Z);
+        }
+        Use(Z[0]);
+    }, 1.0, 1);
+
+    //% State and transition matrix over the same arc: VarEqn (42 equations) and Accel
+    //% integrated separately, as the extended filter does, against PropagateSTM
+    Bench("STM/VarEqn+Accel/3600s", [&]() {
+        double Z[6], yPhi[42] = {0};
+        memcpy(Z, Y, sizeof(Z));
+        for (int i = 0; i < 6; i++) {
+            yPhi[i] = Y[i];
+            yPhi[6*(i+1)+i] = 1.0;
+        }
+        RKInteg([&pg](double x, const double* y, double* dy) { VarEqn(x, y, dy, pg); },
+                0, 3600.0, 1e-13, 1e-6, 42, yPhi);
+        RKInteg(fg, 0, 3600.0, 1e-13, 1e-6, 6, Z);
+        Use(Z[0] + yPhi[6]);
+    }, 1.0, 1);
+    Bench("STM/PropagateSTM/3600s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        Matrix Phi(6,6);
+        PropagateSTM(0, 3600.0, Z, Phi, pg);
+        Use(Z[0] + Phi(1,1));
+    }, 1.0, 1);
+
+    //% Earth orientation and ephemerides
+    Bench("IERS", [&]() {
+        double x_pole, y_pole, UT1_UTC, LOD, dpsi, deps, dx_pole, dy_pole, TAI_UTC;
+        IERS(*global::eopdate, global::Mjd_UTC, 'l', x_pole, y_pole, UT1_UTC, LOD, dpsi, deps, dx_pole, dy_pole, TAI_UTC);
+        Use(UT1_UTC);
+    });
+    Bench("NutMatrix", [&]() { Matrix N = NutMatrix(global::Mjd_TT); Use(N(1,1)); });
+
+    if (!jpl) {
+        printf("\n../data/DE430Coeff.txt not found: JPL_Eph_DE430, Accel, VarEqn, DEInteg and EKF_GEOS3 skipped\n");
+        return 0;
+    }
+
+    Bench("JPL_Eph_DE430", [&]() {
+        double rb[11][3];
+        double *r_Mercury = rb[0], *r_Venus = rb[1], *r_Earth = rb[2], *r_Mars = rb[3], *r_Jupiter = rb[4],
+               *r_Saturn = rb[5], *r_Uranus = rb[6], *r_Neptune = rb[7], *r_Pluto = rb[8], *r_Moon = rb[9], *r_Sun = rb[10];
+        JPL_Eph_DE430(Mjday_TDB(global::Mjd_TT), r_Mercury, r_Venus, r_Earth, r_Mars, r_Jupiter, r_Saturn,
+                      r_Uranus, r_Neptune, r_Pluto, r_Moon, r_Sun);
+        Use(r_Sun[0]);
+    });
+
+    //% Force model and variational equations
+    AccelParam param = GlobalAccelParam();
+    Bench("Accel", [&]() {
+        double dY[6];
+        Accel(0.0, Y, dY, param);
+        Use(dY[3]);
+    });
+    double yPhi[42] = {0};
+    for (int i = 0; i < 6; i++) {
+        yPhi[i] = Y[i];
+        yPhi[6*(i+1)+i] = 1.0;
+    }
+    Bench("VarEqn", [&]() {
+        double yPhip[42];
+        VarEqn(0.0, yPhi, yPhip, param);
+        Use(yPhip[3]);
+    });
+
+    //% Propagation over one pass (one hour) and the whole filter
+    Bench("DEInteg/3600s", [&]() {
+        double Z[6];
+        memcpy(Z, Y, sizeof(Z));
+        DEInteg(Accel, 0, 3600.0, 1e-13, 1e-6, 6, Z);
+        Use(Z[0]);
+    }, 1.0, 1);
+    Bench("EKF_GEOS3", [&]() { EKF_GEOS3(); }, 1.0, 1);
+
+    return 0;
+}
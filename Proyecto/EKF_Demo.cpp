@@ -0,0 +1,20 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include "EKF_GEOS3.h"
+#include "global.h"
+
+/**
+ * @file EKF_Demo.cpp
+ * @brief Determinación de la órbita de GEOS-3 con el filtro de Kalman extendido.
+ *
+ * Debe ejecutarse desde un directorio hermano de `data` (p. ej. el de compilación).
+ */
+int main()
+{
+    global::GGM03S(20);
+    EKF_GEOS3();
+
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <cstdio>
 #include <cmath>
+#include <thread>
+#include <stdexcept>
 #include "./include/Matrix.h"
 #include "global.h"
 #include "R_z.h"
@@ -40,6 +42,24 @@
 #include "Accel.h"
 #include "DEInteg.h"
 #include "EKF_GEOS3.h"
+#include "MeasModel.h"
+#include "BatchLSQ.h"
+#include "RTSSmoother.h"
+#include "UKF.h"
+#include "ProcessNoise.h"
+#include "RKInteg.h"
+#include "GJInteg.h"
+#include "AccelBatch.h"
+#include "Events.h"
+#include "Stats.h"
+#include "GravityTruncation.h"
+#include "GravityGrid.h"
+#include "Density.h"
+#include "AccelDrag.h"
+#include "AccelSolrad.h"
+#include "ForceModel.h"
+#include "SolidTides.h"
+#include "SAT_Const.h"
 
 int tests_run = 0;
 
@@ -68,6 +88,23 @@ int proMat_01()
     
     return 0;
 }
+int inverse_01(){
+
+    //% Zero leading pivot: the rows must be exchanged
+    double v[] = {0.0, 1.0, 2.0,
+                  1.0, 0.0, 3.0,
+                  4.0, -3.0, 8.0};
+    Matrix A(3, 3, v, 9);
+    Matrix B = A.inverse();
+    Matrix C = A*B;
+    for (int i = 1; i <= 3; i++) {
+        for (int j = 1; j <= 3; j++) {
+            _assert(fabs(C(i,j) - (i == j ? 1.0 : 0.0)) < 1e-12);
+        }
+    }
+
+    return 0;
+}
 int R_z_01(){
     Matrix r(3,3);
     Matrix m(3,3);
@@ -705,6 +742,1311 @@ int DeInteg_01(){
 
     return 0;
 }
+int MeasModel_01(){
+
+    double lon = 1.0, lat = 0.5, alt = 100.0;
+    double r[3] = {7000e3, 1200e3, 1300e3};
+    Matrix U = R_z(0.3);
+
+    MeasModel model;
+    model.addStation(0.2, -0.4, 10.0, 1.0, 1.0, 1.0);
+    int k = model.addStation(lon, lat, alt, 1.0, 1.0, 1.0);
+    MeasPrediction pred;
+    model.predict(k, U, r, pred);
+
+    double* Rs = Position(lon, lat, alt);
+    Matrix LT = LTC(lon, lat);
+    double s[3];
+    for (int i = 0; i < 3; i++) {
+        double d = 0.0;
+        for (int j = 0; j < 3; j++) {
+            double rb = U(j+1,1)*r[0] + U(j+1,2)*r[1] + U(j+1,3)*r[2];
+            d += LT(i+1,j+1)*(rb - Rs[j]);
+        }
+        s[i] = d;
+    }
+    auto* dA = new double[3];
+    auto* dE = new double[3];
+    double Az, El;
+    AzElPa(s, dA, dE, Az, El);
+
+    _assert(fabs(pred.value[MEAS_AZIMUTH]-Az)<10e-14 and fabs(pred.value[MEAS_ELEVATION]-El)<10e-14
+    and fabs(pred.value[MEAS_RANGE]-sqrt(s[0]*s[0]+s[1]*s[1]+s[2]*s[2]))<10e-8);
+
+    //% Range partials against finite differences
+    double rp[3] = {r[0]+1.0, r[1], r[2]};
+    MeasPrediction pred2;
+    model.predict(k, U, rp, pred2);
+    _assert(fabs((pred2.value[MEAS_RANGE]-pred.value[MEAS_RANGE])-pred.dzdY[MEAS_RANGE][0])<10e-6
+    and pred.dzdY[MEAS_AZIMUTH][3]==0.0);
+
+    return 0;
+}
+int BatchLSQ_01(){
+
+    MeasModel model;
+    model.addStation(1.0, 0.5, 100.0, 1e-4, 1e-4, 10.0);
+
+    std::vector<Observation> obs;
+    std::vector<int> node;
+    std::vector<double> Ynode, Phinode, Unode;
+    for (int k = 0; k < 4; k++) {
+        double Y[6] = {7000e3 + 1e5*k, 1200e3, 1300e3 - 2e5*k, 0, 7.5e3, 0};
+        for (int i = 0; i < 6; i++) Ynode.push_back(Y[i]);
+        for (int i = 0; i < 36; i++) Phinode.push_back((i % 7 == 0) ? 1.0 : 0.01*i);
+        Matrix U = R_z(0.1*k);
+        for (int i = 0; i < 3; i++) for (int j = 0; j < 3; j++) Unode.push_back(U(i+1,j+1));
+        for (int t = 0; t < 3; t++) {
+            obs.push_back({50000.0 + k, 0, (MEAS_TYPE) t, 0.5 + 1000.0*t});
+            node.push_back(k);
+        }
+    }
+
+    double N1[36], b1[6], chi21;
+    double N3[36], b3[6], chi23;
+    NormalEquations(model, obs, node, Ynode, Phinode, Unode, 1, N1, b1, chi21);
+    NormalEquations(model, obs, node, Ynode, Phinode, Unode, 3, N3, b3, chi23);
+
+    for (int i = 0; i < 36; i++) {
+        _assert(fabs(N1[i]-N3[i]) <= 10e-12*fabs(N1[i]));
+    }
+    for (int i = 0; i < 6; i++) {
+        _assert(fabs(b1[i]-b3[i]) <= 10e-12*fabs(b1[i]));
+        _assert(fabs(N1[6*i+5-i]-N1[6*(5-i)+i]) <= 10e-12*fabs(N1[6*i+5-i]));
+    }
+    _assert(fabs(chi21-chi23) <= 10e-12*chi21);
+
+    return 0;
+}
+int BatchLSQ_02(){
+
+    //% Simulated 30 min arc from two stations (gravity field only), perturbed a priori state
+    double Mjd0 = 4.974611128472211e+04;
+    double x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC;
+    IERS(*global::eopdate,Mjd0,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+    timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = Mjd0;
+    p.Mjd_TT = Mjd0 + TT_UTC/86400;
+    p.n = 10;
+    p.m = 10;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+
+    MeasModel model;
+    model.addStation(Rad*(-158.2706), Rad*21.5748, 300.2, 1e-4, 1e-4, 10.0);
+    model.addStation(Rad*(-110.0), Rad*35.0, 1500.0, 1e-4, 1e-4, 10.0);
+
+    const double Y_true[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                              4645.04725161806, -2752.21591588204, -7507.99940987031};
+    double Y[6];
+    for (int i = 0; i < 6; i++) {
+        Y[i] = Y_true[i];
+    }
+    std::vector<Observation> obs;
+    MeasPrediction pred;
+    for (int k = 1; k <= 30; k++) {
+        RKInteg([&p](double x, const double* y, double* dy) { Accel(x, y, dy, p); },
+                60.0*(k-1),60.0*k,1e-13,1e-6,6,Y);
+        double Mjd = Mjd0 + 60.0*k/86400.0;
+        IERS(*global::eopdate,Mjd,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+        Matrix U = R_z(gmst(Mjd + UT1_UTC/86400));
+        for (int st = 0; st < 2; st++) {
+            model.predict(st, U, Y, pred);
+            for (int t = 0; t < 3; t++) {
+                obs.push_back({Mjd, st, (MEAS_TYPE) t, pred.value[t]});
+            }
+        }
+    }
+
+    double Y0[6] = {Y_true[0]+1000.0, Y_true[1]-800.0, Y_true[2]+500.0,
+                    Y_true[3]+1.0, Y_true[4]-1.0, Y_true[5]+0.5};
+    Matrix P(6,6);
+    for (int i = 1; i <= 6; i++) {
+        P(i,i) = (i <= 3) ? 1e8 : 1e3;
+    }
+    int iter = BatchLSQ(model, obs, Mjd0, Y0, P, 10, 1e-6, 2, INTEG_RK, &p);
+    printf("BatchLSQ: %d iterations, dr = %.3e m\n", iter,
+           sqrt(pow(Y0[0]-Y_true[0],2)+pow(Y0[1]-Y_true[1],2)+pow(Y0[2]-Y_true[2],2)));
+    _assert(iter < 10);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(Y0[i]-Y_true[i]) < 1.0 and fabs(Y0[i+3]-Y_true[i+3]) < 1e-3);
+    }
+
+    return 0;
+}
+int RTSSmoother_01(){
+
+    Matrix Pf0(6,6), Phi = Matrix::identity(6), Q(6,6);
+    for (int i = 1; i <= 6; i++) {
+        Pf0(i,i) = (i <= 3) ? 1e4 : 1.0;
+        Q(i,i) = 1e-2;
+        if (i <= 3) {
+            Phi(i,i+3) = 10.0;
+            Pf0(i,i+3) = 5.0; Pf0(i+3,i) = 5.0;
+        }
+    }
+    Matrix Pp1 = Phi*Pf0*Phi.transpose() + Q;
+    Matrix Pf1(6,6);
+    for (int i = 1; i <= 6; i++) for (int j = 1; j <= 6; j++) Pf1(i,j) = 0.5*Pp1(i,j);
+
+    double xf0[6] = {7000e3, 10.0, -20.0, 1.0, 7.5e3, 0.5};
+    double xp1[6], xf1[6];
+    for (int i = 0; i < 6; i++) {
+        xp1[i] = 0.0;
+        for (int j = 0; j < 6; j++) xp1[i] += Phi(i+1,j+1)*xf0[j];
+        xf1[i] = xp1[i] + 3.0*(i+1);
+    }
+
+    RTSSmoother rts(2);
+    Matrix I6 = Matrix::identity(6);
+    rts.storePrediction(50000.0, xf0, Pf0, I6);
+    rts.storeUpdate(xf0, Pf0);
+    rts.storePrediction(50000.1, xp1, Pp1, Phi);
+    rts.storeUpdate(xf1, Pf1);
+    rts.smooth();
+
+    Matrix C = Pf0*Phi.transpose()*Pp1.inverse();
+    Matrix dP = Pf1 - Pp1;
+    Matrix Ps0 = Pf0 + C*dP*C.transpose();
+    double xs0[6], Y[6];
+    rts.getState(0, Y);
+    Matrix P(6,6);
+    rts.getCovariance(0, P);
+    for (int i = 0; i < 6; i++) {
+        xs0[i] = xf0[i];
+        for (int j = 0; j < 6; j++) xs0[i] += C(i+1,j+1)*(xf1[j]-xp1[j]);
+        _assert(fabs(xs0[i]-Y[i]) < 10e-8);
+    }
+    _assert(P.equalMatrix(P,Ps0,10e-8));
+    rts.getState(1, Y);
+    _assert(fabs(Y[0]-xf1[0]) < 10e-14 and rts.getEpochs() == 2);
+
+    //% Nine states: three decoupled extra components leave the first six unchanged
+    Matrix Pf9(9,9), Pp9(9,9), Pu9(9,9), Phi9 = Matrix::identity(9), I9 = Matrix::identity(9);
+    for (int i = 1; i <= 6; i++) {
+        for (int j = 1; j <= 6; j++) {
+            Pf9(i,j) = Pf0(i,j);
+            Pp9(i,j) = Pp1(i,j);
+            Pu9(i,j) = Pf1(i,j);
+            Phi9(i,j) = Phi(i,j);
+        }
+    }
+    for (int i = 7; i <= 9; i++) {
+        Pf9(i,i) = 1e-12;
+        Pp9(i,i) = 2e-12;
+        Pu9(i,i) = 1.5e-12;
+    }
+    double x9f0[9], x9p1[9], x9f1[9], Y9[9];
+    for (int i = 0; i < 9; i++) {
+        x9f0[i] = i < 6 ? xf0[i] : 1e-6;
+        x9p1[i] = i < 6 ? xp1[i] : 1e-6;
+        x9f1[i] = i < 6 ? xf1[i] : 2e-6;
+    }
+    RTSSmoother rts9(2, 9);
+    rts9.storePrediction(50000.0, x9f0, Pf9, I9);
+    rts9.storeUpdate(x9f0, Pf9);
+    rts9.storePrediction(50000.1, x9p1, Pp9, Phi9);
+    rts9.storeUpdate(x9f1, Pu9);
+    rts9.smooth();
+    rts9.getState(0, Y9);
+    Matrix P9(9,9);
+    rts9.getCovariance(0, P9);
+    for (int i = 0; i < 6; i++) {
+        _assert(fabs(Y9[i]-xs0[i]) < 10e-8);
+        for (int j = 0; j < 6; j++) {
+            _assert(fabs(P9(i+1,j+1)-Ps0(i+1,j+1)) < 10e-8);
+        }
+    }
+    _assert(fabs(Y9[6] - (1e-6 + 0.5*1e-6)) < 1e-15 and rts9.getStates() == 9);
+
+    return 0;
+}
+int UKF_01(){
+
+    double Y[6] = {7000e3, 1200e3, 1300e3, 1.0, 7.5e3, 0.5};
+    Matrix P(6,6);
+    for (int i = 1; i <= 6; i++) {
+        P(i,i) = (i <= 3) ? 1e6 : 1.0;
+    }
+    P(1,2) = 2e5; P(2,1) = 2e5;
+
+    double X[78], Wm[13], Wc[13];
+    SigmaPoints(Y, P, X, Wm, Wc);
+    for (int i = 0; i < 6; i++) {
+        double m = 0.0;
+        for (int l = 0; l < 13; l++) m += Wm[l]*X[6*l+i];
+        _assert(fabs(m-Y[i]) < 10e-8);
+        for (int j = 0; j < 6; j++) {
+            double c = 0.0;
+            for (int l = 0; l < 13; l++) c += Wc[l]*(X[6*l+i]-Y[i])*(X[6*l+j]-Y[j]);
+            _assert(fabs(c-P(i+1,j+1)) < 10e-6);
+        }
+    }
+
+    //% Range update pulls the state towards the measurement
+    MeasModel model;
+    model.addStation(0.2, 0.2, 0.0, 1e-3, 1e-3, 10.0);
+    Matrix U = Matrix::identity(3);
+    MeasPrediction pred;
+    model.predict(0, U, Y, pred);
+    Observation o = {50000.0, 0, MEAS_RANGE, pred.value[MEAS_RANGE] + 500.0};
+    double P11 = P(1,1);
+    UKFMeasUpdate(Y, P, model, U, &o, 1);
+    MeasPrediction pred2;
+    model.predict(0, U, Y, pred2);
+    _assert(fabs(o.value-pred2.value[MEAS_RANGE]) < 100.0 and P(1,1) < P11);
+
+    return 0;
+}
+int ProcessNoise_01(){
+
+    double q = 1e-10;
+    Matrix Q = SNCNoise(60.0, q);
+    _assert(fabs(Q(1,1)-q*72000.0)<10e-14 and fabs(Q(1,4)-q*1800.0)<10e-14 and fabs(Q(4,4)-q*60.0)<10e-14);
+
+    //% Series and closed form agree at the switch beta*dt = 1e-2
+    double tau = 6000.0;
+    Matrix Q1 = DMCNoise(60.0*(1.0-1e-9), tau, q);
+    Matrix Q2 = DMCNoise(60.0*(1.0+1e-9), tau, q);
+    for (int i = 1; i <= 9; i++) {
+        for (int j = 1; j <= 9; j++) {
+            _assert(fabs(Q1(i,j)-Q2(i,j)) <= 1e-4*fabs(Q2(i,j)) and Q2(i,j) == Q2(j,i));
+        }
+    }
+
+    //% Long correlation time: random walk acceleration limit
+    Matrix Q3 = DMCNoise(100.0, 1e12, q);
+    _assert(fabs(Q3(4,4)-q*1e6/3.0) <= 1e-6*Q3(4,4) and fabs(Q3(7,7)-q*100.0) <= 1e-6*Q3(7,7));
+
+    Matrix Phi = DMCTransition(100.0, 1e12);
+    _assert(fabs(Phi(1,7)-5000.0) < 1e-3 and fabs(Phi(4,7)-100.0) < 1e-6);
+
+    //% Filter selection: SNC and no noise on (r,v); DMC only through the augmented state
+    NoiseParam snc = {NOISE_SNC, q, 0.0}, dmc = {NOISE_DMC, q, tau}, none = {NOISE_NONE, q, tau};
+    Matrix Qs = NoiseMatrix(snc, 60.0), Q0 = NoiseMatrix(none, 60.0);
+    for (int i = 1; i <= 6; i++) {
+        for (int j = 1; j <= 6; j++) {
+            _assert(Qs(i,j) == Q(i,j) and Q0(i,j) == 0.0);
+        }
+    }
+    bool thrown = false;
+    try {
+        NoiseMatrix(dmc, 60.0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    _assert(thrown);
+
+    //% Augmented time update: free particle pushed by a decaying acceleration
+    double dt = 300.0, e = exp(-dt/tau);
+    double Yx[9] = {7000e3, 0.0, 0.0, 0.0, 7.5e3, 0.0, 1e-6, -2e-6, 3e-6};
+    double Y0[9];
+    Matrix Pa(9,9), Phi6 = Matrix::identity(6);
+    for (int i = 1; i <= 9; i++) {
+        Pa(i,i) = (i <= 3) ? 1e4 : (i <= 6 ? 1.0 : 0.5*q*tau);
+    }
+    Matrix P0 = Pa;
+    for (int i = 0; i < 9; i++) {
+        Y0[i] = Yx[i];
+    }
+    for (int i = 1; i <= 3; i++) {
+        Phi6(i,i+3) = dt;
+        Yx[i-1] += dt*Yx[i+2];
+    }
+    Matrix Phi9 = DMCTimeUpdate(Yx, Pa, Phi6, dt, tau, q);
+    Matrix Pref = Phi9*P0*Phi9.transpose() + DMCNoise(dt, tau, q);
+    for (int i = 0; i < 3; i++) {
+        double r = Y0[i] + dt*Y0[i+3] + Y0[i+6]*(tau*dt - tau*tau*(1.0-e));
+        double v = Y0[i+3] + Y0[i+6]*tau*(1.0-e);
+        _assert(fabs(Yx[i]-r) < 1e-9 and fabs(Yx[i+3]-v) < 1e-12 and fabs(Yx[i+6]-e*Y0[i+6]) < 1e-20);
+        _assert(Phi9(i+1,i+4) == dt and Phi9(i+7,i+7) == e);
+    }
+    _assert(Pa.equalMatrix(Pa, Pref, 1e-9));
+    _assert(fabs(Pa(7,7) - (e*e*P0(7,7) + DMCNoise(dt, tau, q)(7,7))) < 1e-12*Pa(7,7));
+
+    return 0;
+}
+static double* Oscillator(double, double* y){
+    double* dy = new double[2];
+    dy[0] = y[1];
+    dy[1] = -y[0];
+    return dy;
+}
+static double* Kepler2B(double, double* y){
+    double* dy = new double[6];
+    double r = sqrt(y[0]*y[0]+y[1]*y[1]+y[2]*y[2]);
+    for (int i = 0; i < 3; i++) {
+        dy[i] = y[i+3];
+        dy[i+3] = -GM_Earth*y[i]/(r*r*r);
+    }
+    return dy;
+}
+int RKInteg_01(){
+
+    //% Harmonic oscillator, forwards and backwards over several periods
+    double y[2] = {1.0, 0.0};
+    RKInteg(Oscillator,0,20,1e-13,1e-13,2,y);
+    _assert(fabs(y[0]-cos(20.0))<10e-11 and fabs(y[1]+sin(20.0))<10e-11);
+    RKInteg(Oscillator,20,0,1e-13,1e-13,2,y);
+    _assert(fabs(y[0]-1.0)<10e-11 and fabs(y[1])<10e-11);
+
+    //% Circular Keplerian orbit over one revolution
+    double r = 7000e3, v = sqrt(GM_Earth/r);
+    double T = pi2*sqrt(r*r*r/GM_Earth);
+    double Y[6] = {r, 0, 0, 0, v, 0};
+    RKInteg(Kepler2B,0,T,1e-13,1e-6,6,Y);
+    _assert(fabs(Y[0]-r)<1e-3 and fabs(Y[1])<1e-3 and fabs(Y[4]-v)<1e-6);
+
+    return 0;
+}
+int GJInteg_01(){
+
+    //% Circular Keplerian orbit over five revolutions, 60 s steps
+    double r = 7000e3, v = sqrt(GM_Earth/r);
+    double T = pi2*sqrt(r*r*r/GM_Earth);
+    double Y[6] = {r, 0, 0, 0, v, 0};
+    GJInteg(Kepler2B,0,5*T,60.0,6,Y);
+    _assert(fabs(Y[0]-r)<1e-2 and fabs(Y[1])<5e-2 and fabs(Y[4]-v)<1e-5);
+
+    //% Backwards, and short arcs handed over to RKInteg
+    double Z[6] = {r, 0, 0, 0, v, 0};
+    GJInteg(Kepler2B,0,-T,60.0,6,Z);
+    _assert(fabs(Z[0]-r)<1e-2 and fabs(Z[1])<1e-2);
+    double W[6] = {r, 0, 0, 0, v, 0};
+    GJInteg(Kepler2B,0,T/4.0,600.0,6,W);
+    _assert(fabs(W[0])<1e-3 and fabs(W[1]-r)<1e-3);
+
+    return 0;
+}
+int Integ_01(){
+
+    //% Capturing lambdas: per-propagation parameters without globals
+    double w = 2.0;
+    int nfcn = 0;
+    auto osc = [w, &nfcn](double, const double* y, double* dy) {
+        dy[0] = y[1];
+        dy[1] = -w*w*y[0];
+        nfcn++;
+    };
+    double y[2] = {1.0, 0.0};
+    RKInteg(osc,0,5,1e-13,1e-13,2,y);
+    _assert(fabs(y[0]-cos(10.0))<10e-11 and fabs(y[1]+2.0*sin(10.0))<10e-11 and nfcn > 0);
+
+    //% Same orbit with the buffer interface and the heap-array wrapper
+    double r = 7000e3, v = sqrt(GM_Earth/r);
+    double GM = GM_Earth;
+    auto kepler = [GM](double, const double* y, double* dy) {
+        double rr = sqrt(y[0]*y[0]+y[1]*y[1]+y[2]*y[2]);
+        for (int i = 0; i < 3; i++) {
+            dy[i] = y[i+3];
+            dy[i+3] = -GM*y[i]/(rr*rr*rr);
+        }
+    };
+    double Y1[6] = {r, 0, 0, 0, v, 0}, Y2[6] = {r, 0, 0, 0, v, 0};
+    GJInteg(kepler,0,3600,60.0,6,Y1);
+    GJInteg(Kepler2B,0,3600,60.0,6,Y2);
+    for (int i = 0; i < 6; i++) {
+        _assert(Y1[i] == Y2[i]);
+    }
+
+    //% Shampine & Gordon with a capturing lambda, forwards and backwards
+    nfcn = 0;
+    double z[2] = {1.0, 0.0};
+    DEInteg(osc,0,5,1e-13,1e-13,2,z);
+    _assert(fabs(z[0]-cos(10.0))<10e-11 and fabs(z[1]+2.0*sin(10.0))<10e-11 and nfcn > 0);
+    DEInteg(osc,5,0,1e-13,1e-13,2,z);
+    _assert(fabs(z[0]-1.0)<10e-11 and fabs(z[1])<10e-11);
+
+    //% Integrations nested in the right-hand side and in the observer, with the same
+    //% and a different number of equations
+    double maxin = 0.0;
+    auto nested = [&osc, &maxin, w](double, const double* y, double* dy) {
+        double u[2] = {1.0, 0.0}, e[1] = {1.0};
+        RKInteg(osc,0,0.01,1e-13,1e-13,2,u);
+        DEInteg(osc,0,0.01,1e-13,1e-13,2,u);
+        DEInteg([](double, const double* q, double* dq) { dq[0] = -q[0]; },0,0.01,1e-13,1e-13,1,e);
+        maxin = fmax(maxin, fmax(fabs(u[0]-cos(2.0*w*0.01)), fabs(e[0]-exp(-0.01))));
+        dy[0] = y[1];
+        dy[1] = -w*w*y[0];
+    };
+    double yn[2] = {1.0, 0.0}, zn[2] = {1.0, 0.0};
+    RKInteg(nested,0,5,1e-13,1e-13,2,yn,0,[&osc](double, const double*, const double*) {
+        double u[3] = {1.0, 0.0, 0.0};
+        RKInteg(osc,0,0.01,1e-13,1e-13,2,u);
+    });
+    DEInteg(nested,0,5,1e-13,1e-13,2,zn);
+    _assert(fabs(yn[0]-cos(10.0))<10e-11 and fabs(yn[1]+2.0*sin(10.0))<10e-11);
+    _assert(fabs(zn[0]-cos(10.0))<10e-11 and fabs(zn[1]+2.0*sin(10.0))<10e-11);
+    _assert(maxin < 1e-11);
+
+    //% An integration left by an exception releases its buffers
+    bool thrown = false;
+    try {
+        RKInteg(nested,0,5,1e-13,1e-13,2,yn,0,[](double x, const double*, const double*) {
+            if (x > 1.0) {
+                throw std::runtime_error("stop");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    _assert(thrown);
+    yn[0] = 1.0;
+    yn[1] = 0.0;
+    RKInteg(nested,0,5,1e-13,1e-13,2,yn);
+    _assert(fabs(yn[0]-cos(10.0))<10e-11);
+
+    return 0;
+}
+int AccelBatch_01(){
+
+    //% Batched harmonic kernel against AccelHarmonic, with a padded last block
+    const int N = 11;
+    Matrix E = R_z(0.3)*R_x(0.2);
+    double r[3*N], a[3*N];
+    for (int k = 0; k < N; k++) {
+        r[3*k] = 7000e3*cos(0.5*k);
+        r[3*k+1] = 6900e3*sin(0.5*k);
+        r[3*k+2] = 1000e3*(k-5);
+    }
+    AccelHarmonicBatch(N, r, E, 20, 20, a);
+    for (int k = 0; k < N; k++) {
+        double* ak = AccelHarmonic(&r[3*k], E, 20, 20);
+        for (int i = 0; i < 3; i++) {
+            _assert(fabs(a[3*k+i]-ak[i]) < 1e-12*fabs(ak[i]) + 1e-15);
+        }
+        delete[] ak;
+    }
+
+    //% Lock-step propagation: the step error is the worst of the blocks
+    double Y[12] = {7000e3, 0, 0, 0, sqrt(GM_Earth/7000e3), 0,
+                    42164e3, 0, 0, 0, sqrt(GM_Earth/42164e3), 0};
+    double Y1[6] = {7000e3, 0, 0, 0, sqrt(GM_Earth/7000e3), 0};
+    auto kepler = [](double t, const double* y, double* dy) {
+        for (int k = 0; k < 2; k++) {
+            double* d = Kepler2B(t, const_cast<double*>(&y[6*k]));
+            for (int i = 0; i < 6; i++) {
+                dy[6*k+i] = d[i];
+            }
+            delete[] d;
+        }
+    };
+    RKInteg(kepler,0,6000,1e-13,1e-6,12,Y,6);
+    RKInteg(Kepler2B,0,6000,1e-13,1e-6,6,Y1);
+    for (int i = 0; i < 6; i++) {
+        _assert(fabs(Y[i]-Y1[i]) < 1e-3);
+    }
+
+    return 0;
+}
+class BiasForcing : public SensitivityForcing {
+public:
+    void dadp(double, const double*, int col, double* da) const override {
+        if (col == 7) {
+            da[0] = 1.0;
+        }
+    }
+};
+int VarEqnColumns_01(){
+
+    //% Harmonic field only: reference trajectory with dense output
+    AccelParam p = GlobalAccelParam();
+    p.n = 4;
+    p.m = 4;
+    double Y0[6] = {7000e3, 1200e3, 1300e3, -1000, 7300, 500};
+    double Y[6];
+    for (int i = 0; i < 6; i++) {
+        Y[i] = Y0[i];
+    }
+    auto harmonic = [&p](double x, const double* y, double* dy) {
+        Matrix E = VarEqnFrame(x, p);
+        double r[3] = {y[0], y[1], y[2]};
+        double* a = AccelHarmonic(r, E, p.n, p.m);
+        for (int i = 0; i < 3; i++) {
+            dy[i] = y[i+3];
+            dy[i+3] = a[i];
+        }
+        delete[] a;
+    };
+    DenseOrbit ref;
+    RKInteg(harmonic,0,600,1e-13,1e-6,6,Y,0,
+            [&ref](double x, const double* y, const double* dy) { ref.add(x, y, dy); });
+    double Yi[6];
+    ref.eval(600, Yi);
+    _assert(ref.getNodes() > 2 and fabs(Yi[0]-Y[0]) < 1e-6 and fabs(Yi[3]-Y[3]) < 1e-9);
+
+    //% Without gradient samples the columns cannot be propagated
+    Matrix Phi = Matrix::identity(6);
+    bool thrown = false;
+    try {
+        VarEqnColumns(ref, 0, 600, Phi);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    _assert(thrown);
+
+    //% Gradient sampled every 30 s, independently of the accepted steps
+    double G[9], Gi[9];
+    for (int k = 0; k <= 20; k++) {
+        ref.eval(30.0*k, Yi);
+        VarEqnGradient(30.0*k, Yi, p, G);
+        ref.addGradient(30.0*k, G);
+    }
+    _assert(ref.getGradients() == 21);
+
+    //% Interpolated gradient against the direct one between the samples
+    ref.eval(315, Yi);
+    VarEqnGradient(315, Yi, p, G);
+    ref.evalGradient(315, Gi);
+    double Gmax = 0.0;
+    for (int i = 0; i < 9; i++) {
+        Gmax = fmax(Gmax, fabs(G[i]));
+    }
+    for (int i = 0; i < 9; i++) {
+        _assert(fabs(Gi[i]-G[i]) < 1e-6*Gmax);
+    }
+
+    //% Six STM columns (three threads) and a constant acceleration bias along x as a
+    //% parameter column, against the variational equations integrated stage by stage
+    Matrix S(6,7);
+    for (int i = 1; i <= 6; i++) {
+        S(i,i) = 1.0;
+    }
+    BiasForcing bias;
+    VarEqnColumns(ref, 0, 600, S, &bias, 3);
+
+    double yPhi[42] = {0};
+    for (int i = 0; i < 6; i++) {
+        yPhi[i] = Y0[i];
+        yPhi[6*(i+1)+i] = 1.0;
+    }
+    RKInteg([&p](double x, const double* y, double* dy) { VarEqn(x, y, dy, p); },
+            0,600,1e-13,1e-6,42,yPhi);
+    for (int j = 0; j < 6; j++) {
+        for (int i = 0; i < 6; i++) {
+            double ref_ij = yPhi[6*(j+1)+i];
+            _assert(fabs(S(i+1,j+1)-ref_ij) < 1e-6*(1.0+fabs(ref_ij)));
+        }
+    }
+
+    //% Whole propagation with Accel (no third bodies): the reference follows the Earth
+    //% rotation, VarEqn does not, hence the looser tolerance
+    AccelParam pg = p;
+    pg.sun = 0;
+    pg.moon = 0;
+    pg.planets = 0;
+    double Z[6];
+    for (int i = 0; i < 6; i++) {
+        Z[i] = Y0[i];
+    }
+    PropagateSTM(0, 600, Z, Phi, pg);
+    for (int j = 0; j < 6; j++) {
+        for (int i = 0; i < 6; i++) {
+            double ref_ij = yPhi[6*(j+1)+i];
+            _assert(fabs(Phi(i+1,j+1)-ref_ij) < 1e-5*(1.0+fabs(ref_ij)));
+        }
+    }
+
+    double ys[12] = {0};
+    for (int i = 0; i < 6; i++) {
+        ys[i] = Y0[i];
+    }
+    RKInteg([&p, &harmonic](double x, const double* y, double* dy) {
+                double Gx[9];
+                harmonic(x, y, dy);
+                VarEqnGradient(x, y, p, Gx);
+                for (int i = 0; i < 3; i++) {
+                    dy[6+i] = y[9+i];
+                    dy[9+i] = Gx[3*i]*y[6] + Gx[3*i+1]*y[7] + Gx[3*i+2]*y[8] + (i == 0 ? 1.0 : 0.0);
+                }
+            }, 0,600,1e-13,1e-6,12,ys);
+    for (int i = 0; i < 6; i++) {
+        _assert(fabs(S(i+1,7)-ys[6+i]) < 1e-6*(1.0+fabs(ys[6+i])));
+    }
+    _assert(fabs(S(1,7)) > 1e4);
+
+    return 0;
+}
+class CrossingEvent : public EventFunction {
+public:
+    double g(double, const double* Y) const override { return Y[1]; }
+};
+int Events_01(){
+
+    //% Circular equatorial orbit: node crossings at T/2 and T
+    double r = 7000e3, v = sqrt(GM_Earth/r);
+    double T = pi2*sqrt(r*r*r/GM_Earth);
+    auto f = [](double, const double* y, double* dy) {
+        double d = sqrt(y[0]*y[0]+y[1]*y[1]+y[2]*y[2]);
+        for (int i = 0; i < 3; i++) {
+            dy[i] = y[i+3];
+            dy[i+3] = -GM_Earth*y[i]/(d*d*d);
+        }
+    };
+
+    MeasModel model;
+    int k = model.addStation(0.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+    double Mjd_UT1 = 49746.0, mask = 5.0*Rad;
+    CrossingEvent node;
+    ElevationEvent elev(model, k, Mjd_UT1, mask);
+
+    EventDetector detector(4, 1e-4);
+    detector.addEvent(&node);
+    detector.addEvent(&elev);
+
+    double Y[6] = {r, 1.0, 0, 0, v, 0};
+    RKInteg(f,0,1.01*T,1e-13,1e-6,6,Y,0,detector);
+    const std::vector<Event>& ev = detector.getEvents();
+    int nnode = 0;
+    for (size_t i = 0; i < ev.size(); i++) {
+        if (ev[i].id == 0) {
+            nnode++;
+            _assert(fabs(ev[i].t - nnode*T/2.0) < 1e-2);
+            _assert(ev[i].direction == (nnode == 1 ? -1 : 1));
+        }
+    }
+    _assert(nnode == 2);
+
+    //% Rise and set times over a day agree with the elevation of the propagated orbit
+    detector.clear();
+    double Z[6] = {r, 0, 0, 0, v, 0};
+    RKInteg(f,0,86400.0,1e-13,1e-6,6,Z,0,detector);
+    _assert(ev.size() >= 2);
+    int rises = 0, sets = 0;
+    for (size_t i = 0; i < ev.size(); i++) {
+        if (ev[i].id != 1) {
+            continue;
+        }
+        double W[6] = {r, 0, 0, 0, v, 0};
+        RKInteg(f,0,ev[i].t,1e-13,1e-6,6,W);
+        Matrix U = R_z(gmst(Mjd_UT1 + ev[i].t/86400.0));
+        MeasPrediction pred;
+        model.predict(k, U, W, pred);
+        _assert(fabs(pred.value[MEAS_ELEVATION] - mask) < 1e-6);
+        if (ev[i].direction == 1) {
+            rises++;
+        } else {
+            sets++;
+        }
+        _assert(rises - sets == 0 or rises - sets == 1);
+    }
+    _assert(rises > 0);
+
+    return 0;
+}
+int Stats_01(){
+
+    double r = 7000e3, v = sqrt(GM_Earth/r);
+    double T = pi2*sqrt(r*r*r/GM_Earth);
+    double Y[6] = {r, 0, 0, 0, v, 0};
+
+    StatsReset();
+    int nobs = 0;
+    RKInteg([](double, const double* y, double* dy) {
+                double d = sqrt(y[0]*y[0]+y[1]*y[1]+y[2]*y[2]);
+                for (int i = 0; i < 3; i++) {
+                    dy[i] = y[i+3];
+                    dy[i+3] = -GM_Earth*y[i]/(d*d*d);
+                }
+            },0,T,1e-13,1e-6,6,Y,0,[&nobs](double, const double*, const double*) { nobs++; });
+
+    Stats s;
+    StatsTotal(s);
+#ifdef PROYECTO_STATS
+    //% One observer call per accepted step plus the initial point
+    _assert(s.count[STAT_RK_STEPS] == (unsigned long long) (nobs-1));
+    _assert(s.count[STAT_RK_FCN] == 2 + 12*s.count[STAT_RK_STEPS] + 11*s.count[STAT_RK_REJECTED]);
+
+    //% Counters of finished threads are kept
+    std::thread worker([]() { STAT_ADD(STAT_DE_STEPS, 5); });
+    worker.join();
+    StatsTotal(s);
+    _assert(s.count[STAT_DE_STEPS] == 5);
+#else
+    _assert(nobs > 1 and s.count[STAT_RK_STEPS] == 0);
+#endif
+
+    return 0;
+}
+int GGM03S_01(){
+
+    Matrix Cnm = *global::Cnm;
+    Matrix Snm = *global::Snm;
+
+    //% Degree-truncated load: same coefficients as the full field
+    global::GGM03S(20);
+    _assert(global::Cnm->getRows() == 21 and global::Snm->getCol() == 21);
+    _assert(fabs((*global::Cnm)(3,1) - (-4.841692638330e-04)) < 1e-16);
+    _assert(fabs((*global::Snm)(3,2) - 1.464715526673e-09) < 1e-21);
+    for (int n = 0; n <= 20; n++) {
+        for (int m = 0; m <= n; m++) {
+            _assert((*global::Cnm)(n+1,m+1) == Cnm(n+1,m+1) and (*global::Snm)(n+1,m+1) == Snm(n+1,m+1));
+        }
+    }
+
+    //% The force model cannot go beyond the loaded degree
+    double r[3] = {7000e3, 0, 0};
+    bool thrown = false;
+    try {
+        AccelHarmonic(r, Matrix::identity(3), 30, 30);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    _assert(thrown);
+
+    //% Reloading replaces the tables (the truncated ones are freed)
+    global::GGM03S();
+    _assert(global::Cnm->getRows() == 181 and (*global::Cnm)(181,181) == Cnm(181,181));
+
+    return 0;
+}
+int GravityTruncation_01(){
+
+    const double tol = 1e-9;
+    GravityTruncation trunc(*global::Cnm, *global::Snm, tol);
+    Matrix E = Matrix::identity(3);
+
+    //% The degree falls with the distance and the omitted terms stay within the budget
+    const double radius[3] = {7000e3, 26560e3, 42164e3};
+    int last = 181;
+    for (int k = 0; k < 3; k++) {
+        int n = trunc.degree(radius[k], 70);
+        _assert(n < last and n >= 2);
+        _assert(trunc.tail(radius[k], n, 70) <= tol);
+        last = n;
+        for (int l = 0; l < 5; l++) {
+            double lat = -1.2 + 0.6*l, lon = 1.3*l;
+            double r[3] = {radius[k]*cos(lat)*cos(lon), radius[k]*cos(lat)*sin(lon), radius[k]*sin(lat)};
+            double* a = AccelHarmonic(r, E, n, n);
+            double* b = AccelHarmonic(r, E, 70, 70);
+            double da = sqrt(pow(a[0]-b[0],2) + pow(a[1]-b[1],2) + pow(a[2]-b[2],2));
+            _assert(da < 5*tol);
+            delete[] a;
+            delete[] b;
+        }
+    }
+    _assert(trunc.degree(7000e3, 70) > 30 and trunc.degree(42164e3, 70) < 10);
+
+    //% Fixed degree unless a truncation is given
+    AccelParam p = GlobalAccelParam();
+    p.n = 70;
+    p.m = 50;
+    int n, m;
+    GravityDegree(p, 42164e3, n, m);
+    _assert(n == 70 and m == 50);
+    p.trunc = &trunc;
+    GravityDegree(p, 42164e3, n, m);
+    _assert(n == trunc.degree(42164e3, 70) and m == n);
+
+    return 0;
+}
+int GravityGrid_01(){
+
+    //% Degree 20 on a 2 deg grid over 6800-7200 km
+    GravityGrid grid(20, 20, 6800e3, 7200e3, 6, 91, 180, 2);
+    _assert(grid.maxError(500) < 5e-7);
+
+    //% Rotated frame, as used by Accel
+    Matrix E = R_z(0.7);
+    double r[3] = {6000e3, 3000e3, 1500e3};
+    double a[3];
+    _assert(grid.accel(r, E, a));
+    double* b = AccelHarmonic(r, E, 20, 20);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(a[i]-b[i]) < 5e-7);
+    }
+    delete[] b;
+
+    //% Outside the shell the caller falls back to the direct sum
+    double far[3] = {42164e3, 0, 0};
+    _assert(!grid.accel(far, E, a) and !grid.contains(6700e3));
+
+    //% Save and reload
+    grid.save("GravityGrid_01.bin");
+    GravityGrid copy("GravityGrid_01.bin");
+    remove("GravityGrid_01.bin");
+    double c[3];
+    _assert(copy.accel(r, E, c) and copy.getDegree() == 20);
+    grid.accel(r, E, a);
+    _assert(a[0] == c[0] and a[1] == c[1] and a[2] == c[2]);
+
+    return 0;
+}
+int ThirdBody_01(){
+
+    //% Sun- and Moon-like bodies on three satellites, against the single-body function
+    double s1[3] = {1.4e11, -2.0e10, 8.0e9}, s2[3] = {-2.5e8, 2.8e8, 1.1e8};
+    double r[9] = {7000e3, 100e3, -300e3, -42164e3, 10e3, 0.0, 3000e3, -6000e3, 2000e3};
+    PointMasses b;
+    b.add(s1, GM_Sun);
+    b.add(s2, GM_Moon);
+    double a[9] = {1.0, 2.0, 3.0, 0, 0, 0, 0, 0, 0};
+    AccelPointMass(b, 3, r, a);
+    for (int k = 0; k < 3; k++) {
+        double* a1 = AccelPointMass(&r[3*k], s1, GM_Sun);
+        double* a2 = AccelPointMass(&r[3*k], s2, GM_Moon);
+        for (int i = 0; i < 3; i++) {
+            double ref = (k == 0 ? i+1.0 : 0.0) + a1[i] + a2[i];
+            _assert(fabs(a[3*k+i] - ref) < 1e-12*(1.0 + fabs(ref)));
+        }
+        delete[] a1;
+        delete[] a2;
+    }
+
+    //% Tidal acceleration of the Moon at the Earth's surface, along the Earth-Moon line
+    double sm[3] = {384400e3, 0, 0}, rs[3] = {R_Earth, 0, 0};
+    double* at = AccelPointMass(rs, sm, GM_Moon);
+    double d = 384400e3 - R_Earth;
+    _assert(fabs(at[0] - GM_Moon*(1.0/(d*d) - 1.0/(384400e3*384400e3))) < 1e-15);
+    _assert(at[1] == 0.0 and at[2] == 0.0);
+    delete[] at;
+
+    return 0;
+}
+int Drag_01(){
+
+    //% Harris-Priester at table altitudes: bulge apex (Sun 30 deg behind) and antapex
+    HarrisPriester hp(3.0);
+    double r[3] = {R_Earth + 400e3, 0.0, 0.0};
+    double s_apex[3] = {AU*cos(0.523599), -AU*sin(0.523599), 0.0};
+    double s_anti[3] = {-s_apex[0], -s_apex[1], 0.0};
+    _assert(fabs(hp.density(0.0, r, s_apex) - 7.492e-12) < 1e-12*7.492e-12*1e3);
+    _assert(fabs(hp.density(0.0, r, s_anti) - 2.249e-12) < 1e-12*2.249e-12*1e3);
+
+    //% Exponential decay inside a bin, zero outside 100-1000 km
+    double r2[3] = {R_Earth + 410e3, 0.0, 0.0};
+    _assert(fabs(hp.density(0.0, r2, s_anti) - sqrt(2.249*1.558)*1e-12) < 1e-9*2e-12);
+    double r3[3] = {R_Earth + 1200e3, 0.0, 0.0}, r4[3] = {0.0, 0.0, 6356e3 + 50e3};
+    _assert(hp.density(0.0, r3, s_apex) == 0.0 and hp.density(0.0, r4, s_apex) == 0.0);
+
+    //% Drag opposite to the velocity relative to the rotating atmosphere
+    double v[3] = {0.0, 7670.0, 0.0};
+    double a[3] = {0.0, 0.0, 0.0};
+    Matrix T = Matrix::identity(3);
+    AccelDrag(hp, 0.0, r, v, s_apex, T, 10.0, 1000.0, 2.2, a);
+    double v_rel = 7670.0 - omega_Earth*r[0];
+    _assert(fabs(a[1] + 0.5*2.2*0.01*7.492e-12*v_rel*v_rel) < 1e-9*fabs(a[1]));
+    _assert(a[0] == 0.0 and a[2] == 0.0);
+
+    //% Cache: reused within the window, re-evaluated outside
+    CachedDensity cache(hp, 60.0, 100e3);
+    double rho = cache.density(50000.0, r, s_apex);
+    _assert(cache.density(50000.0 + 30.0/86400.0, r2, s_apex) == rho);
+    _assert(cache.getCalls() == 1);
+    _assert(cache.density(50000.0 + 120.0/86400.0, r2, s_apex) == hp.density(0.0, r2, s_apex));
+    _assert(cache.getCalls() == 2);
+
+    //% Shared by two threads: each one reuses only its own evaluations
+    CachedDensity shared(hp, 60.0, 100e3);
+    double rho_main = shared.density(50000.0, r, s_apex), rho_other = 0.0;
+    std::thread worker([&]() { rho_other = shared.density(50000.0, r2, s_apex); });
+    worker.join();
+    _assert(rho_other == hp.density(0.0, r2, s_apex) and rho_other != rho_main);
+    _assert(shared.density(50000.0, r2, s_apex) == rho_main);
+    _assert(shared.getCalls() == 2);
+
+    return 0;
+}
+int Solrad_01(){
+
+    //% Umbra, sunlight and the centre of the penumbra for every model
+    double s[3] = {AU, 0.0, 0.0};
+    double r_umbra[3] = {-7000e3, 0.0, 0.0}, r_sun[3] = {0.0, 7000e3, 0.0};
+    const ShadowModel models[3] = {SHADOW_CYLINDRICAL, SHADOW_CONICAL, SHADOW_SMOOTH};
+    for (int k = 0; k < 3; k++) {
+        _assert(Shadow(r_umbra, s, models[k]) == 0.0);
+        _assert(Shadow(r_sun, s, models[k]) == 1.0);
+    }
+    _assert(Shadow(r_umbra, s, SHADOW_NONE) == 1.0);
+
+    //% Across the penumbra: against the exact overlap of the two disks
+    double r0 = 7000e3;
+    double b = asin(R_Earth/r0);
+    double prev_c = 0.0, prev_s = 0.0, maxerr = 0.0;
+    for (int i = 0; i <= 400; i++) {
+        double c = b + 0.4*Rad*(i - 200)/200.0;        // Earth-Sun separation seen from the satellite
+        double r[3] = {-r0*cos(c), r0*sin(c), 0.0};
+        double d[3] = {s[0]-r[0], s[1]-r[1], s[2]-r[2]};
+        double nd = sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+        double a = asin(R_Sun/nd);
+        double cs = acos(-(r[0]*d[0] + r[1]*d[1])/(r0*nd));
+        double nu = 1.0;
+        if (cs < b - a) {
+            nu = 0.0;
+        } else if (cs < a + b) {
+            double x = (cs*cs + a*a - b*b)/(2.0*cs);
+            double y = sqrt(a*a - x*x);
+            double A = a*a*acos(x/a) + b*b*acos((cs-x)/b) - cs*y;
+            nu = 1.0 - A/(pi2/2.0*a*a);
+        }
+        double nc = Shadow(r, s, SHADOW_CONICAL);
+        double ns = Shadow(r, s, SHADOW_SMOOTH);
+        maxerr = fmax(maxerr, fabs(nc - nu));
+        _assert(nc >= prev_c and ns >= prev_s);
+        _assert(fabs(ns - nc) < 0.1);
+        prev_c = nc;
+        prev_s = ns;
+    }
+    _assert(maxerr < 1e-3);
+
+    //% A wider smooth transition starts in the umbra and ends in sunlight
+    double c1 = b - 1.5*R_Sun/AU;
+    double r1[3] = {-r0*cos(c1), r0*sin(c1), 0.0};
+    _assert(Shadow(r1, s, SHADOW_CONICAL) == 0.0);
+    _assert(Shadow(r1, s, SHADOW_SMOOTH, 3.0) > 0.0);
+
+    //% Radiation pressure at 1 AU, directed away from the Sun
+    double a[3] = {0.0, 0.0, 0.0};
+    double rs[3] = {0.0, 0.0, 0.0};
+    AccelSolrad(rs, s, 10.0, 1000.0, 1.3, 1.0, a);
+    _assert(fabs(a[0] + 1.3*0.01*P_Sol) < 1e-12*P_Sol);
+    _assert(a[1] == 0.0 and a[2] == 0.0);
+    AccelSolrad(rs, s, 10.0, 1000.0, 1.3, 0.0, a);
+    _assert(fabs(a[0] + 1.3*0.01*P_Sol) < 1e-12*P_Sol);
+
+    return 0;
+}
+/**
+ * @brief Contribuyente de prueba: aceleración constante.
+ */
+class ConstantForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override {
+        (void) c;
+        a[0] += 1e-6;
+    }
+    const char* name() const override { return "Constant"; }
+};
+
+int ForceModel_01(){
+
+    //% Force model without ephemerides (no third bodies, drag or radiation pressure)
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = 4.974611128472211e+04;
+    p.n = 20;
+    p.m = 20;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+    double Y[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                   4645.04725161806, -2752.21591588204, -7507.99940987031};
+
+    //% Standard composition, the same contributors at run time, and the batch
+    double dY[6], dYr[6], dYb[6];
+    Accel(60.0, Y, dY, p);
+    HarmonicForce harmonic;
+    ThirdBodyForce third;
+    DragForce drag;
+    SolradForce solrad;
+    ForceRegistry registry(true);
+    registry.add(harmonic);
+    registry.add(third);
+    registry.add(drag);
+    registry.add(solrad);
+    Accel(60.0, Y, dYr, p, registry);
+    AccelBatch(60.0, 1, Y, dYb, p);
+    for (int i = 0; i < 6; i++) {
+        _assert(dYr[i] == dY[i]);
+        _assert(fabs(dYb[i] - dY[i]) < 1e-12*fabs(dY[i]));
+    }
+    _assert(registry.size() == 4 and registry.getCalls(0) == 1 and registry.getCalls(3) == 1);
+    _assert(registry.getSeconds(0) > 0.0);
+
+    //% An added contributor, composed statically and dynamically
+    ConstantForce constant;
+    registry.add(constant);
+    Accel(60.0, Y, dYr, p, registry);
+    ForceSum<HarmonicForce, ConstantForce> sum;
+    double dYs[6];
+    Accel(60.0, Y, dYs, p, sum);
+    _assert(fabs(dYr[3] - dY[3] - 1e-6) < 1e-15 and dYr[4] == dY[4]);
+    _assert(dYs[3] == dYr[3] and dYs[5] == dYr[5]);
+    _assert(registry.getCalls(0) == 2 and registry.getCalls(4) == 1);
+    registry.resetCounters();
+    _assert(registry.getCalls(0) == 0 and registry.getSeconds(0) == 0.0);
+
+    return 0;
+}
+int SolidTides_01(){
+
+    //% Sun and Moon on the equator at longitude 0: closed-form corrections
+    double s[3] = {AU, 0.0, 0.0}, mo[3] = {384400e3, 0.0, 0.0};
+    double dC[5][5], dS[5][5];
+    SolidTides(s, mo, dC, dS);
+    double f = GM_Sun/GM_Earth*pow(R_Earth/AU, 3) + GM_Moon/GM_Earth*pow(R_Earth/384400e3, 3);
+    _assert(fabs(dC[2][0] - 0.30190/5.0*f*(-sqrt(5.0)/2.0)) < 1e-12*fabs(dC[2][0]));
+    _assert(fabs(dC[2][2] - 0.30102/5.0*f*sqrt(15.0)/2.0) < 1e-12*fabs(dC[2][2]));
+    _assert(fabs(dS[2][2] - 0.00130/5.0*f*sqrt(15.0)/2.0) < 1e-12*fabs(dS[2][2]));
+    _assert(fabs(dC[4][0] - 0.00089/5.0*f*sqrt(5.0)/2.0) < 1e-12*fabs(dC[4][0]));
+    _assert(fabs(dC[2][1]) < 1e-20 and fabs(dS[2][1]) < 1e-20 and fabs(dC[3][0]) < 1e-20);
+    _assert(fabs(dC[2][0]) > 1e-9 and fabs(dC[2][0]) < 1e-8);
+
+    //% Patched block against the same change in the shared table
+    double zC[5][5] = {{0.0}}, zS[5][5] = {{0.0}};
+    zC[2][0] = 1e-8;
+    zS[3][1] = -2e-9;
+    GravityPatch patch;
+    patch.set(zC, zS);
+    double r[3] = {6000e3, 3000e3, 1500e3};
+    Matrix E = R_z(0.3)*R_x(0.2);
+    double* ap = AccelHarmonic(r, E, 20, 20, &patch);
+    double* a0 = AccelHarmonic(r, E, 20, 20);
+    (*global::Cnm)(3,1) += 1e-8;
+    (*global::Snm)(4,2) += -2e-9;
+    double* ag = AccelHarmonic(r, E, 20, 20);
+    (*global::Cnm)(3,1) -= 1e-8;
+    (*global::Snm)(4,2) -= -2e-9;
+    double ab[3], ad[3] = {a0[0], a0[1], a0[2]};
+    AccelHarmonicBatch(1, r, E, 20, 20, ab, &patch);
+    AccelPatch(r, E, patch, ad);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(ap[i] - ag[i]) < 1e-14*fabs(ag[i]) + 1e-18);
+        _assert(fabs(ab[i] - ag[i]) < 1e-12*fabs(ag[i]));
+        _assert(fabs(ad[i] - ag[i]) < 1e-12*fabs(ag[i]));
+        _assert(ap[i] != a0[i]);
+    }
+    delete[] ap;
+    delete[] a0;
+    delete[] ag;
+
+    return 0;
+}
+int TideCache_01(){
+
+    //% Sun and Moon turning about the z axis in the Earth-fixed frame
+    double Mjd0 = 4.974611128472211e+04;
+    auto bodies = [Mjd0](double Mjd_UTC, double* s_bf, double* m_bf) {
+        double th = 7.292115e-5*(Mjd_UTC - Mjd0)*86400.0;
+        s_bf[0] = AU*cos(th);
+        s_bf[1] = AU*sin(th);
+        s_bf[2] = 0.3*AU;
+        m_bf[0] = 384400e3*cos(0.9*th + 1.0);
+        m_bf[1] = 384400e3*sin(0.9*th + 1.0);
+        m_bf[2] = -5e7;
+    };
+    auto exact = [&bodies](double Mjd_UTC, GravityPatch& patch) {
+        double s_bf[3], m_bf[3], dC[5][5], dS[5][5];
+        bodies(Mjd_UTC, s_bf, m_bf);
+        SolidTides(s_bf, m_bf, dC, dS);
+        patch.set(dC, dS);
+    };
+    _assert(GlobalAccelParam().tide_step == 0.0);
+
+    //% Nodes every 60 s: exact at the nodes, one new node per interval
+    double h = 60.0;
+    double t0 = floor(Mjd0*86400.0/h)*h;
+    TideCache cache;
+    GravityPatch ref, mid;
+    exact((t0 + h)/86400.0, ref);
+    cache.get((t0 + h)/86400.0, h, bodies);
+    _assert(fabs(cache.patch.C[2][2] - ref.C[2][2]) < 1e-12*fabs(ref.C[2][2]));
+    _assert(fabs(cache.patch.S[3][1] - ref.S[3][1]) < 1e-12*fabs(ref.S[3][1]));
+    TideCache steps;
+    for (int k = 0; k <= 10; k++) {
+        steps.get((t0 + h + 3.0 + 5.0*k)/86400.0, h, bodies);
+    }
+    _assert(steps.evaluations == 2);
+    exact((t0 + 1.5*h)/86400.0, mid);
+    steps.get((t0 + 1.5*h)/86400.0, h, bodies);
+    _assert(steps.evaluations == 2);
+    _assert(fabs(steps.patch.C[2][2] - mid.C[2][2]) < 1e-2*fabs(mid.C[2][2] - ref.C[2][2]));
+    steps.get((t0 + 2.5*h)/86400.0, h, bodies);
+    _assert(steps.evaluations == 3);
+
+    //% Continuous across a node
+    double a = cache.get((t0 + 2.0*h - 1e-3)/86400.0, h, bodies).C[2][1];
+    double b = cache.get((t0 + 2.0*h + 1e-3)/86400.0, h, bodies).C[2][1];
+    _assert(fabs(b - a) < 1e-3*fabs(mid.C[2][1] - ref.C[2][1]));
+
+    //% Independent of the history of the cache
+    TideCache fresh;
+    double t = (t0 + 1.3*h)/86400.0;
+    cache.get((t0 - 7.0*h)/86400.0, h, bodies);
+    cache.get(t, h, bodies);
+    fresh.get(t, h, bodies);
+    for (int n = 0; n <= 4; n++) {
+        for (int m = 0; m <= n; m++) {
+            _assert(cache.patch.C[n][m] == fresh.patch.C[n][m] and cache.patch.S[n][m] == fresh.patch.S[n][m]);
+        }
+    }
+
+    return 0;
+}
+int Relativity_01(){
+
+    //% Circular orbit: radial correction GM/(c^2 r^2) (4 GM/r - v^2) = 3 (GM/(c r))^2/r
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = 4.974611128472211e+04;
+    p.n = 20;
+    p.m = 20;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+    double r0 = 7000e3, v0 = sqrt(GM_Earth/r0);
+    double Y[6] = {r0, 0.0, 0.0, 0.0, v0, 0.0};
+    ForceContext c;
+    c.p = &p;
+    c.setState(Y);
+    RelativityForce rel;
+    double a[3] = {0.0, 0.0, 0.0};
+    p.relativity = 0;
+    rel.accumulate(c, a);
+    _assert(a[0] == 0.0);
+    p.relativity = 1;
+    rel.accumulate(c, a);
+    double ref = 3.0*GM_Earth*GM_Earth/(c_light*c_light*r0*r0*r0);
+    _assert(fabs(a[0] - ref) < 1e-12*ref and a[1] == 0.0 and a[2] == 0.0);
+    _assert(ref > 1e-8 and ref < 2e-8);
+
+    //% Switched on in Accel through AccelParam
+    double Ye[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                    4645.04725161806, -2752.21591588204, -7507.99940987031};
+    double dY0[6], dY1[6], ar[3] = {0.0, 0.0, 0.0};
+    p.relativity = 0;
+    Accel(0.0, Ye, dY0, p);
+    p.relativity = 1;
+    Accel(0.0, Ye, dY1, p);
+    c.setState(Ye);
+    rel.accumulate(c, ar);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(dY1[i+3] - dY0[i+3] - ar[i]) < 1e-14);
+    }
+
+    //% The batch evaluation includes it as well
+    double Yb[12], dYb[12], dYa[6];
+    for (int i = 0; i < 6; i++) {
+        Yb[i] = Ye[i];
+        Yb[i+6] = Y[i];
+    }
+    AccelBatch(0.0, 2, Yb, dYb, p);
+    Accel(0.0, Y, dYa, p);
+    for (int i = 0; i < 6; i++) {
+        _assert(fabs(dYb[i] - dY1[i]) < 1e-12*fabs(dY1[i]) + 1e-18);
+        _assert(fabs(dYb[i+6] - dYa[i]) < 1e-12*fabs(dYa[i]) + 1e-18);
+    }
+
+    return 0;
+}
+int MixedHarmonic_01(){
+
+    //% Mixed-precision kernel against the double one (padded blocks, N = 1 and N = 19)
+    const int N = 19;
+    Matrix E = R_z(0.3)*R_x(0.2);
+    double r[3*N], ad[3*N], am[3*N], a1[3];
+    for (int k = 0; k < N; k++) {
+        r[3*k] = 7000e3*cos(0.5*k);
+        r[3*k+1] = 6900e3*sin(0.5*k);
+        r[3*k+2] = 1000e3*(k-9);
+    }
+    const int degree[2] = {20, 70};
+    for (int j = 0; j < 2; j++) {
+        AccelHarmonicBatch(N, r, E, degree[j], degree[j], ad);
+        AccelHarmonicMixed(N, r, E, degree[j], degree[j], am);
+        for (int k = 0; k < N; k++) {
+            AccelHarmonicMixed(1, &r[3*k], E, degree[j], degree[j], a1);
+            for (int i = 0; i < 3; i++) {
+                _assert(fabs(am[3*k+i] - ad[3*k+i]) < 1e-10);
+                _assert(fabs(a1[i] - am[3*k+i]) < 1e-10);
+            }
+        }
+    }
+
+    //% One hour of the GEOS-3 arc through Accel: difference below a millimetre
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = 4.974611128472211e+04;
+    p.n = 20;
+    p.m = 20;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+    AccelParam q = p;
+    q.mixed = 1;
+    double Yd[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                    4645.04725161806, -2752.21591588204, -7507.99940987031};
+    double Ym[6] = {Yd[0], Yd[1], Yd[2], Yd[3], Yd[4], Yd[5]};
+    RKInteg([&p](double x, const double* y, double* dy) { Accel(x, y, dy, p); }, 0, 3600.0, 1e-13, 1e-6, 6, Yd);
+    RKInteg([&q](double x, const double* y, double* dy) { Accel(x, y, dy, q); }, 0, 3600.0, 1e-13, 1e-6, 6, Ym);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(Ym[i] - Yd[i]) < 1e-3);
+    }
+
+    return 0;
+}
+int AccelHarmonicFused_01(){
+
+    //% Fused kernel against the batch one (full Legendre rows), zonal/tesseral and patched
+    const int N = 7;
+    Matrix E = R_z(0.3)*R_x(0.2);
+    double r[3*N], ab[3*N], a[3];
+    for (int k = 0; k < N; k++) {
+        r[3*k] = 7000e3*cos(0.9*k);
+        r[3*k+1] = 6900e3*sin(0.9*k);
+        r[3*k+2] = 2000e3*(k-3);
+    }
+    GravityPatch patch;
+    double dC[5][5] = {{0}}, dS[5][5] = {{0}};
+    dC[2][0] = 3e-9;
+    dC[4][2] = -1e-9;
+    dS[3][1] = 2e-9;
+    patch.set(dC, dS);
+    const int degree[3][2] = {{20, 20}, {70, 70}, {70, 10}};
+    for (int j = 0; j < 3; j++) {
+        int n = degree[j][0], m = degree[j][1];
+        for (int q = 0; q < 2; q++) {
+            const GravityPatch* gp = q ? &patch : nullptr;
+            AccelHarmonicBatch(N, r, E, n, m, ab, gp);
+            for (int k = 0; k < N; k++) {
+                AccelHarmonic(&r[3*k], E, n, m, a, gp);
+                double na = sqrt(ab[3*k]*ab[3*k] + ab[3*k+1]*ab[3*k+1] + ab[3*k+2]*ab[3*k+2]);
+                for (int i = 0; i < 3; i++) {
+                    _assert(fabs(a[i] - ab[3*k+i]) < 1e-12*na);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+int IntegCompare_01(){
+
+    //% DEInteg and RKInteg on the same arc: one hour, and sixty 60 s hops
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = 4.974611128472211e+04;
+    p.n = 20;
+    p.m = 20;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+    int nde = 0, nrk = 0;
+    auto fde = [&p, &nde](double x, const double* y, double* dy) { Accel(x, y, dy, p); nde++; };
+    auto frk = [&p, &nrk](double x, const double* y, double* dy) { Accel(x, y, dy, p); nrk++; };
+    const double Y0[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                          4645.04725161806, -2752.21591588204, -7507.99940987031};
+    double Yde[6], Yrk[6], Zde[6], Zrk[6];
+    for (int i = 0; i < 6; i++) {
+        Yde[i] = Yrk[i] = Zde[i] = Zrk[i] = Y0[i];
+    }
+    DEInteg(fde,0,3600.0,1e-13,1e-6,6,Yde);
+    RKInteg(frk,0,3600.0,1e-13,1e-6,6,Yrk);
+    printf("3600 s: DEInteg %d, RKInteg %d evaluations\n", nde, nrk);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(Yde[i]-Yrk[i]) < 1e-2 and fabs(Yde[i+3]-Yrk[i+3]) < 1e-5);
+    }
+
+    nde = nrk = 0;
+    for (int k = 0; k < 60; k++) {
+        DEInteg(fde,60.0*k,60.0*(k+1),1e-13,1e-6,6,Zde);
+        RKInteg(frk,60.0*k,60.0*(k+1),1e-13,1e-6,6,Zrk);
+    }
+    printf("60 x 60 s: DEInteg %d, RKInteg %d evaluations\n", nde, nrk);
+    for (int i = 0; i < 3; i++) {
+        _assert(fabs(Zde[i]-Zrk[i]) < 1e-2 and fabs(Zde[i]-Yrk[i]) < 1e-2);
+    }
+
+    return 0;
+}
 int Main_01(){
 
     EKF_GEOS3();
@@ -717,6 +2059,7 @@ int Main_01(){
 int all_tests()
 {
     _verify(proMat_01);
+    _verify(inverse_01);
     _verify(R_z_01);
     _verify(R_x_01);
     _verify(R_y_01);
@@ -751,6 +2094,32 @@ int all_tests()
     _verify(AccelHarmonic_01);
     _verify(G_AccelHarmonic_01);
     _verify(IERS_01);
+    _verify(MeasModel_01);
+    _verify(BatchLSQ_01);
+    _verify(BatchLSQ_02);
+    _verify(RTSSmoother_01);
+    _verify(UKF_01);
+    _verify(ProcessNoise_01);
+    _verify(RKInteg_01);
+    _verify(GJInteg_01);
+    _verify(Integ_01);
+    _verify(AccelBatch_01);
+    _verify(VarEqnColumns_01);
+    _verify(Events_01);
+    _verify(Stats_01);
+    _verify(GGM03S_01);
+    _verify(GravityTruncation_01);
+    _verify(GravityGrid_01);
+    _verify(ThirdBody_01);
+    _verify(Drag_01);
+    _verify(Solrad_01);
+    _verify(ForceModel_01);
+    _verify(SolidTides_01);
+    _verify(TideCache_01);
+    _verify(Relativity_01);
+    _verify(MixedHarmonic_01);
+    _verify(AccelHarmonicFused_01);
+    _verify(IntegCompare_01);
     //_verify(VarEqn_01); No funciona bien
     //_verify(Accel_01); No funciona bien
     //_verify(Accel_01); No funciona bien
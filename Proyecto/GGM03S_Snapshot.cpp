@@ -0,0 +1,24 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cstdio>
+#include "global.h"
+
+/**
+ * @file GGM03S_Snapshot.cpp
+ * @brief Genera la instantánea binaria `data/GGM03S.bin` a partir de `data/GGM03S.txt`.
+ *
+ * Debe ejecutarse desde un directorio hermano de `data` (p. ej. el de compilación). La
+ * instantánea guarda los dobles en el orden de bytes de la máquina; si no coincide con el de
+ * la que la lee, `global::GGM03S` vuelve a leer el fichero de texto.
+ */
+int main()
+{
+    remove("../data/GGM03S.bin");
+    global::GGM03S();
+    global::GGM03S_bin("../data/GGM03S.bin");
+    printf("../data/GGM03S.bin: degree %d\n", global::Cnm->getRows()-1);
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "global.h"
+#include "Accel.h"
+#include "AccelBatch.h"
+#include "RKInteg.h"
+
+/*%--------------------------------------------------------------------------
+%
+% HarmonicPrecision: Validation of the mixed-precision harmonic sum
+%
+% Propagates the GEOS-3 state of the test arc (epoch of the first
+% observation) with the gravity field alone, once with the double
+% harmonic sum and once with the mixed-precision one (AccelParam::mixed),
+% and reports the position difference every hour and its growth per day.
+% Also prints the largest acceleration difference over the arc.
+%
+% Usage (from a directory next to ../data):
+%   HarmonicPrecision [days=1] [degree=20]
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file HarmonicPrecision.cpp
+ * @brief Comparación de la suma armónica en precisión mixta con la de doble precisión.
+ */
+int main(int argc, char** argv)
+{
+    double days = argc > 1 ? atof(argv[1]) : 1.0;
+    int degree = argc > 2 ? atoi(argv[2]) : 20;
+
+    global::eop19620101();
+    global::GGM03S(degree);
+    global::AuxParam();
+
+    AccelParam p = GlobalAccelParam();
+    p.Mjd_UTC = 4.974611128472211e+04;
+    p.n = degree;
+    p.m = degree;
+    p.sun = 0;
+    p.moon = 0;
+    p.planets = 0;
+    AccelParam q = p;
+    q.mixed = 1;
+
+    double Yd[6] = {6221397.62857869, 2867713.77965738, 3006155.98509949,
+                    4645.04725161806, -2752.21591588204, -7507.99940987031};
+    double Ym[6];
+    for (int i = 0; i < 6; i++) {
+        Ym[i] = Yd[i];
+    }
+
+    auto fd = [&p](double x, const double* y, double* dy) { Accel(x, y, dy, p); };
+    auto fm = [&q](double x, const double* y, double* dy) { Accel(x, y, dy, q); };
+
+    printf("Mixed-precision harmonic sum, degree %d, %.2f days\n", degree, days);
+    printf("%10s%16s%16s\n", "t [h]", "|dr| [m]", "max |da| [m/s^2]");
+
+    double da_max = 0.0, dr_day = 0.0;
+    int nh = (int) ceil(24.0*days);
+    for (int h = 1; h <= nh; h++) {
+        double t0 = 3600.0*(h-1), t1 = 3600.0*h;
+        RKInteg(fd, t0, t1, 1e-13, 1e-6, 6, Yd);
+        RKInteg(fm, t0, t1, 1e-13, 1e-6, 6, Ym);
+
+        //% Acceleration difference on the double trajectory
+        double ad[6], am[6];
+        Accel(t1, Yd, ad, p);
+        Accel(t1, Yd, am, q);
+        double da = sqrt(pow(ad[3]-am[3], 2) + pow(ad[4]-am[4], 2) + pow(ad[5]-am[5], 2));
+        da_max = da > da_max ? da : da_max;
+
+        double dr = sqrt(pow(Yd[0]-Ym[0], 2) + pow(Yd[1]-Ym[1], 2) + pow(Yd[2]-Ym[2], 2));
+        printf("%10d%16.6f%16.3e\n", h, dr, da);
+        if (h % 24 == 0 || h == nh) {
+            printf("%10s%16.6f  growth per day (day %d)\n", "", dr - dr_day, (h+23)/24);
+            dr_day = dr;
+        }
+    }
+    printf("\nMaximum acceleration difference: %.3e m/s^2\n", da_max);
+
+    return 0;
+}
@@ -5,7 +5,45 @@
 #ifndef PROYECTO_ACCEL_H
 #define PROYECTO_ACCEL_H
 
+#include "AccelPointMass.h"
+#include "AccelSolrad.h"
 
+class GravityTruncation;
+class GravityGrid;
+class DensityModel;
+
+/**
+ * @brief Época y modelo de fuerzas de una propagación (AuxParam en la versión MATLAB).
+ */
+struct AccelParam {
+    double Mjd_UTC;
+    double Mjd_TT;
+    int n;
+    int m;
+    int sun;
+    int moon;
+    int planets;
+    const GravityTruncation* trunc;     // Adaptive degree (nullptr: fixed n, m)
+    const GravityGrid* grid;            // Tabulated field (nullptr: direct sum)
+    const DensityModel* density;        // Atmospheric density (nullptr: no drag)
+    double mass;                        // Spacecraft mass [kg]
+    double area_drag;                   // Cross-section for drag [m^2]
+    double CD;                          // Drag coefficient
+    int sRad;                           // Solar radiation pressure
+    double area_solar;                  // Cross-section for radiation pressure [m^2]
+    double CR;                          // Radiation pressure coefficient
+    ShadowModel shadow;                 // Earth shadow model for radiation pressure
+    double shadow_width;                // Transition width factor of SHADOW_SMOOTH
+    int tides;                          // Solid Earth tides (degree 2 to 4)
+    double tide_step;                   // Node spacing of the interpolated tide corrections [s] (0: exact)
+    int relativity;                     // Post-Newtonian (Schwarzschild) correction
+    int mixed;                          // Mixed-precision harmonic sum (screening)
+};
+
+AccelParam GlobalAccelParam();
+void GravityDegree(const AccelParam& p, double d, int& n, int& m);
+PointMasses ThirdBodies(double Mjd_TT, const AccelParam& p, double* r_Sun = nullptr, double* r_Moon = nullptr);
+void Accel(double x, const double* Y, double* dY, const AccelParam& p);
 double* Accel(double x,double* Y);
 
 
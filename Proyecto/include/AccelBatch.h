@@ -0,0 +1,20 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_ACCELBATCH_H
+#define PROYECTO_ACCELBATCH_H
+
+#include "Matrix.h"
+#include "Accel.h"
+
+struct GravityPatch;
+
+void AccelHarmonicBatch(int N, const double* r, Matrix& E, int n_max, int m_max, double* a,
+                        const GravityPatch* patch = nullptr);
+void AccelHarmonicMixed(int N, const double* r, Matrix& E, int n_max, int m_max, double* a,
+                        const GravityPatch* patch = nullptr);
+void AccelBatch(double x, int N, const double* Y, double* dY, const AccelParam& p);
+double* PropagateBatch(int N, double t, double tout, double relerr, double abserr, double* Y, const AccelParam& p);
+
+#endif //PROYECTO_ACCELBATCH_H
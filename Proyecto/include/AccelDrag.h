@@ -0,0 +1,14 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_ACCELDRAG_H
+#define PROYECTO_ACCELDRAG_H
+
+#include "Matrix.h"
+#include "Density.h"
+
+void AccelDrag(const DensityModel& model, double Mjd_TT, const double* r, const double* v, const double* r_Sun,
+               Matrix& T, double Area, double mass, double CD, double* a);
+
+#endif //PROYECTO_ACCELDRAG_H
@@ -8,7 +8,11 @@
 
 #include "Matrix.h"
 
-double* AccelHarmonic(double* r, Matrix E, int n_max, int m_max);
+struct GravityPatch;
+
+double* AccelHarmonic(double* r, const Matrix& E, int n_max, int m_max, const GravityPatch* patch = nullptr);
+void AccelHarmonic(const double* r, const Matrix& E, int n_max, int m_max, double* a,
+                   const GravityPatch* patch = nullptr);
 
 
 #endif //PROYECTO_ACCELHARMONIC_H
@@ -6,7 +6,21 @@
 #define PROYECTO_ACCELPOINTMASS_H
 
 
-double* AccelPointMass(double* r,double* s,float GM);
+/**
+ * @brief Masas puntuales perturbadoras de una época (posiciones geocéntricas por componentes).
+ */
+struct PointMasses {
+    static const int MAXBODY = 11;
+    int n;
+    double x[MAXBODY], y[MAXBODY], z[MAXBODY], GM[MAXBODY];
+    double ind[3];          // Indirect acceleration sum GM*s/|s|^3
+
+    PointMasses();
+    void add(const double* s, double GM);
+};
+
+double* AccelPointMass(double* r,double* s,double GM);
+void AccelPointMass(const PointMasses& b, int N, const double* r, double* a);
 
 
 #endif //PROYECTO_ACCELPOINTMASS_H
@@ -0,0 +1,18 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_ACCELSOLRAD_H
+#define PROYECTO_ACCELSOLRAD_H
+
+enum ShadowModel {
+    SHADOW_NONE,            // Always illuminated
+    SHADOW_CYLINDRICAL,     // Umbra only, illumination 0 or 1
+    SHADOW_CONICAL,         // Umbra and penumbra (geometric fraction)
+    SHADOW_SMOOTH           // Conical with a C2 polynomial transition
+};
+
+double Shadow(const double* r, const double* r_Sun, ShadowModel model, double width = 1.0);
+void AccelSolrad(const double* r, const double* r_Sun, double Area, double mass, double CR, double nu, double* a);
+
+#endif //PROYECTO_ACCELSOLRAD_H
@@ -0,0 +1,22 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_BATCHLSQ_H
+#define PROYECTO_BATCHLSQ_H
+
+#include <vector>
+#include "Matrix.h"
+#include "MeasModel.h"
+#include "Accel.h"
+#include "Integrator.h"
+
+void NormalEquations(MeasModel& model, std::vector<Observation>& obs, std::vector<int>& node,
+                     std::vector<double>& Ynode, std::vector<double>& Phinode, std::vector<double>& Unode,
+                     int nthreads, double* N, double* b, double& chi2);
+
+int BatchLSQ(MeasModel& model, std::vector<Observation>& obs, double Mjd0, double* Y0,
+             Matrix& P, int maxit, double tol, int nthreads = 0, Integrator integ = INTEG_RK,
+             const AccelParam* force = nullptr);
+
+#endif //PROYECTO_BATCHLSQ_H
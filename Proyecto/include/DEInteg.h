@@ -5,6 +5,512 @@
 #ifndef PROYECTO_DEINTEG_H
 #define PROYECTO_DEINTEG_H
 
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "sign_.h"
+#include "Stats.h"
+
+/**
+ * @brief Buffers del integrador de Shampine & Gordon.
+ *
+ * Se reservan una vez por hilo y nivel de anidamiento y se reutilizan mientras no cambie
+ * el número de ecuaciones.
+ * `phi` guarda las 16 diferencias modificadas por columnas (phi(l,i) = phi[(i-1)*n + l]).
+ */
+struct DEWork {
+    int n = 0;
+    std::vector<double> buf;
+    double *yy, *wt, *p, *yp, *phi;
+
+    void resize(int n_eqn);
+};
+
+/**
+ * @brief Buffers de una llamada a `DEInteg`, tomados de la pila del hilo actual.
+ *
+ * Una integración lanzada desde func recibe los buffers del siguiente nivel, así que no
+ * pisa los de la llamada exterior.
+ */
+class DEWorkScope {
+public:
+    explicit DEWorkScope(int n_eqn);
+    ~DEWorkScope();
+    DEWorkScope(const DEWorkScope&) = delete;
+    DEWorkScope& operator=(const DEWorkScope&) = delete;
+
+    DEWork& w;
+};
+
+/**
+ * @brief Integra un sistema de ecuaciones diferenciales ordinarias con el método multipaso
+ * de orden y paso variables de Shampine & Gordon.
+ *
+ * El integrador avanza más allá de tout y obtiene la solución en tout por interpolación.
+ * El error local de cada componente se mantiene por debajo de `relerr*|y_i| + abserr`.
+ *
+ * @param func Invocable func(t, y, dy) que escribe la derivada dy/dt en dy.
+ * @param t Instante inicial.
+ * @param tout Instante final (puede ser anterior a t).
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @param n_eqn Número de ecuaciones.
+ * @param y Estado en t (entrada) y en tout (salida).
+ * @return double* Puntero a y.
+ * @throws std::invalid_argument Si las tolerancias no son válidas.
+ * @throws std::runtime_error Si las tolerancias son demasiado pequeñas para la precisión de la máquina
+ * o se supera el número máximo de pasos.
+ */
+template <class F>
+double* DEInteg(F&& func,double t,double tout,double relerr,double abserr,int n_eqn,double* y) {
+
+    const double fouru = 4.0*std::numeric_limits<double>::epsilon();
+    const double twou = 2.0*std::numeric_limits<double>::epsilon();
+    const int nmax = 100000;
+
+    //% Powers of two (two(n)=2^n) and error estimate factors
+    static const double two[14] = {1.0, 2.0, 4.0, 8.0, 16.0, 32.0, 64.0, 128.0,
+                                   256.0, 512.0, 1024.0, 2048.0, 4096.0, 8192.0};
+    static const double gstr[14] = {1.0, 0.5, 0.0833, 0.0417, 0.0264, 0.0188, 0.0143,
+                                    0.0114, 0.00936, 0.00789, 0.00679, 0.00592, 0.00524, 0.00468};
+
+    //% Return, if output time equals input time
+    if (t == tout) {
+        return y;
+    }
+
+    //% Test for improper parameters
+    double epsilon = fmax(relerr, abserr);
+    if (relerr < 0.0 || abserr < 0.0 || epsilon <= 0.0) {
+        throw std::invalid_argument("DEInteg: invalid tolerances");
+    }
+
+    DEWorkScope scope(n_eqn);
+    DEWork& ws = scope.w;
+    const int n = n_eqn;
+    double* yy = ws.yy;
+    double* wt = ws.wt;
+    double* p = ws.p;
+    double* yp = ws.yp;
+    double* phi = ws.phi;
+    auto PHI = [phi, n](int l, int i) -> double& { return phi[(i-1)*n + l]; };
+
+    //% Coefficients of the step (1-based, as in the reference)
+    double g[14], sig[14], w[14], v[14], alpha[14], beta[14], psi[14];
+    for (int i = 0; i < 14; i++) {
+        g[i] = sig[i] = w[i] = v[i] = alpha[i] = beta[i] = psi[i] = 0.0;
+    }
+
+    //% Interval of integration and weights of the error tolerances
+    double del = tout - t;
+    double absdel = fabs(del);
+    double tend = t + 100.0*del;
+    double releps = relerr/epsilon;
+    double abseps = abserr/epsilon;
+
+    //% Work variables x and yy(*), initial step size
+    double x = t;
+    for (int l = 0; l < n; l++) {
+        yy[l] = y[l];
+    }
+    double h = sign_(fmax(fouru*fabs(x), fabs(tout - x)), tout - x);
+
+    bool start = true, phase1 = true, nornd = true;
+    int k = 1, kold = 0, ns = 0;
+    double hold = 0.0, absh = 0.0;
+
+    for (int nstep = 0; ; nstep++) {
+        if (nstep > nmax) {
+            throw std::runtime_error("DEInteg: maximum number of steps exceeded");
+        }
+
+        //% If already past output point, interpolate solution and return
+        if (fabs(x - t) >= absdel) {
+            double gi[14], rho[14];
+            gi[1] = 1.0;
+            rho[1] = 1.0;
+            double hi = tout - x;
+            int ki = kold + 1;
+            for (int i = 1; i <= ki; i++) {
+                w[i] = 1.0/i;
+            }
+            double term = 0.0;
+            for (int j = 2; j <= ki; j++) {
+                double psijm1 = psi[j-1];
+                double gamma = (hi + term)/psijm1;
+                double eta = hi/psijm1;
+                for (int i = 1; i <= ki+1-j; i++) {
+                    w[i] = gamma*w[i] - eta*w[i+1];
+                }
+                gi[j] = w[1];
+                rho[j] = gamma*rho[j-1];
+                term = psijm1;
+            }
+            for (int l = 0; l < n; l++) {
+                double s = 0.0;
+                for (int j = 1; j <= ki; j++) {
+                    int i = ki+1-j;
+                    s += gi[i]*PHI(l,i);
+                }
+                y[l] = yy[l] + hi*s;
+            }
+            return y;
+        }
+
+        //% Limit step size, set weight vector and take a step
+        h = sign_(fmin(fabs(h), fabs(tend - x)), h);
+        for (int l = 0; l < n; l++) {
+            wt[l] = releps*fabs(yy[l]) + abseps;
+        }
+
+        /*%
+        % Begin block 0
+        %
+        % Check if step size or error tolerance is too small for machine
+        % precision.  If first step, initialize phi array and estimate a
+        % starting step size.
+        %*/
+        if (fabs(h) < fouru*fabs(x)) {
+            throw std::runtime_error("DEInteg: step size too small");
+        }
+        double p5eps = 0.5*epsilon;
+        g[1] = 1.0;
+        g[2] = 0.5;
+        sig[1] = 1.0;
+
+        //% If error tolerance is too small, give up
+        double round = 0.0;
+        for (int l = 0; l < n; l++) {
+            round += (yy[l]/wt[l])*(yy[l]/wt[l]);
+        }
+        round = twou*sqrt(round);
+        if (p5eps < round) {
+            throw std::runtime_error("DEInteg: accuracy requirement not achievable");
+        }
+
+        if (start) {
+            //% Initialize. Compute appropriate step size for first step
+            func(x, yy, yp);
+            STAT_COUNT(STAT_DE_FCN);
+            double sum = 0.0;
+            for (int l = 0; l < n; l++) {
+                PHI(l,1) = yp[l];
+                PHI(l,2) = 0.0;
+                sum += (yp[l]/wt[l])*(yp[l]/wt[l]);
+            }
+            sum = sqrt(sum);
+            absh = fabs(h);
+            if (epsilon < 16.0*sum*h*h) {
+                absh = 0.25*sqrt(epsilon/sum);
+            }
+            h = sign_(fmax(absh, fouru*fabs(x)), h);
+            hold = 0.0;
+            k = 1;
+            kold = 0;
+            start = false;
+            phase1 = true;
+            nornd = true;
+            if (p5eps <= 100.0*round) {
+                nornd = false;
+                for (int l = 0; l < n; l++) {
+                    PHI(l,15) = 0.0;
+                }
+            }
+        }
+        int ifail = 0;
+
+        //% Repeat blocks 1, 2 (and 3) until step is successful
+        int kp1, kp2, km1, km2, knew;
+        double erk, erkm1, erkm2, xold;
+        while (true) {
+
+            /*%
+            % Begin block 1
+            %
+            % Compute coefficients of formulas for this step. Avoid computing
+            % those quantities not changed when step size is not changed.
+            %*/
+            kp1 = k+1;
+            kp2 = k+2;
+            km1 = k-1;
+            km2 = k-2;
+
+            //% ns is the number of steps taken with size h, including the
+            //% current one. When k<ns, no coefficients change.
+            if (h != hold) {
+                ns = 0;
+            }
+            if (ns <= kold) {
+                ns = ns+1;
+            }
+            int nsp1 = ns+1;
+
+            if (k >= ns) {
+                //% Compute those components of alpha(*), beta(*), psi(*), sig(*)
+                //% which are changed
+                beta[ns] = 1.0;
+                alpha[ns] = 1.0/ns;
+                double temp1 = h*ns;
+                sig[nsp1] = 1.0;
+                for (int i = nsp1; i <= k; i++) {
+                    double temp2 = psi[i-1];
+                    psi[i-1] = temp1;
+                    beta[i] = beta[i-1]*psi[i-1]/temp2;
+                    temp1 = temp2 + h;
+                    alpha[i] = h/temp1;
+                    sig[i+1] = i*alpha[i]*sig[i];
+                }
+                psi[k] = temp1;
+
+                //% Compute coefficients g(*); initialize v(*) and set w(*)
+                if (ns > 1) {
+                    //% If order was raised, update diagonal part of v(*)
+                    if (k > kold) {
+                        v[k] = 1.0/(k*kp1);
+                        for (int j = 1; j <= ns-2; j++) {
+                            int i = k-j;
+                            v[i] = v[i] - alpha[j+1]*v[i+1];
+                        }
+                    }
+                    //% Update v(*) and set w(*)
+                    double temp5 = alpha[ns];
+                    for (int iq = 1; iq <= kp1-ns; iq++) {
+                        v[iq] = v[iq] - temp5*v[iq+1];
+                        w[iq] = v[iq];
+                    }
+                    g[nsp1] = w[1];
+                } else {
+                    for (int iq = 1; iq <= k; iq++) {
+                        v[iq] = 1.0/(iq*(iq+1));
+                        w[iq] = v[iq];
+                    }
+                }
+
+                //% Compute the g(*) in the work vector w(*)
+                for (int i = ns+2; i <= kp1; i++) {
+                    double temp6 = alpha[i-1];
+                    for (int iq = 1; iq <= kp2-i; iq++) {
+                        w[iq] = w[iq] - temp6*w[iq+1];
+                    }
+                    g[i] = w[1];
+                }
+            }
+
+            /*%
+            % Begin block 2
+            %
+            % Predict a solution p(*), evaluate derivatives using predicted
+            % solution, estimate local error at order k and errors at orders
+            % k, k-1, k-2 as if constant step size were used.
+            %*/
+
+            //% Change phi to phi star
+            for (int i = nsp1; i <= k; i++) {
+                double temp1 = beta[i];
+                for (int l = 0; l < n; l++) {
+                    PHI(l,i) = temp1*PHI(l,i);
+                }
+            }
+
+            //% Predict solution and differences
+            for (int l = 0; l < n; l++) {
+                PHI(l,kp2) = PHI(l,kp1);
+                PHI(l,kp1) = 0.0;
+                p[l] = 0.0;
+            }
+            for (int j = 1; j <= k; j++) {
+                int i = kp1-j;
+                double temp2 = g[i];
+                for (int l = 0; l < n; l++) {
+                    p[l] += temp2*PHI(l,i);
+                    PHI(l,i) += PHI(l,i+1);
+                }
+            }
+            if (nornd) {
+                for (int l = 0; l < n; l++) {
+                    p[l] = yy[l] + h*p[l];
+                }
+            } else {
+                for (int l = 0; l < n; l++) {
+                    double tau = h*p[l] - PHI(l,15);
+                    p[l] = yy[l] + tau;
+                    PHI(l,16) = (p[l] - yy[l]) - tau;
+                }
+            }
+            xold = x;
+            x = x + h;
+            absh = fabs(h);
+            func(x, p, yp);
+            STAT_COUNT(STAT_DE_FCN);
+
+            //% Estimate errors at orders k, k-1, k-2
+            erkm2 = 0.0;
+            erkm1 = 0.0;
+            erk = 0.0;
+            for (int l = 0; l < n; l++) {
+                double temp3 = 1.0/wt[l];
+                double temp4 = yp[l] - PHI(l,1);
+                if (km2 > 0) {
+                    erkm2 += ((PHI(l,km1) + temp4)*temp3)*((PHI(l,km1) + temp4)*temp3);
+                }
+                if (km2 >= 0) {
+                    erkm1 += ((PHI(l,k) + temp4)*temp3)*((PHI(l,k) + temp4)*temp3);
+                }
+                erk += (temp4*temp3)*(temp4*temp3);
+            }
+            if (km2 > 0) {
+                erkm2 = absh*sig[km1]*gstr[km2]*sqrt(erkm2);
+            }
+            if (km2 >= 0) {
+                erkm1 = absh*sig[k]*gstr[km1]*sqrt(erkm1);
+            }
+            double temp5 = absh*sqrt(erk);
+            double err = temp5*(g[k] - g[kp1]);
+            erk = temp5*sig[kp1]*gstr[k];
+            knew = k;
+
+            //% Test if order should be lowered
+            if (km2 > 0 && fmax(erkm1, erkm2) <= erk) {
+                knew = km1;
+            }
+            if (km2 == 0 && erkm1 <= 0.5*erk) {
+                knew = km1;
+            }
+
+            //% If step is successful continue with block 4
+            if (err <= epsilon) {
+                break;
+            }
+
+            /*%
+            % Begin block 3
+            %
+            % The step is unsuccessful. Restore x, phi(*,*), psi(*). If
+            % 3rd consecutive failure, set order to 1. If step fails more
+            % than 3 times, consider an optimal step size.
+            %*/
+            STAT_COUNT(STAT_DE_REJECTED);
+            phase1 = false;
+            x = xold;
+            for (int i = 1; i <= k; i++) {
+                double temp1 = 1.0/beta[i];
+                for (int l = 0; l < n; l++) {
+                    PHI(l,i) = temp1*(PHI(l,i) - PHI(l,i+1));
+                }
+            }
+            for (int i = 2; i <= k; i++) {
+                psi[i-1] = psi[i] - h;
+            }
+
+            //% On third failure, set order to one.
+            //% Thereafter, use optimal step size
+            ifail = ifail+1;
+            double temp2 = 0.5;
+            if (ifail > 3 && p5eps < 0.25*erk) {
+                temp2 = sqrt(p5eps/erk);
+            }
+            if (ifail >= 3) {
+                knew = 1;
+            }
+            h = temp2*h;
+            k = knew;
+            if (fabs(h) < fouru*fabs(x)) {
+                throw std::runtime_error("DEInteg: step size too small");
+            }
+        }
+
+        /*%
+        % Begin block 4
+        %
+        % The step is successful. Correct the predicted solution, evaluate
+        % the derivatives using the corrected solution and update the
+        % differences. Determine best order and step size for next step.
+        %*/
+        STAT_COUNT(STAT_DE_STEPS);
+        kold = k;
+        hold = h;
+
+        //% Correct and evaluate
+        double temp1 = h*g[kp1];
+        if (nornd) {
+            for (int l = 0; l < n; l++) {
+                yy[l] = p[l] + temp1*(yp[l] - PHI(l,1));
+            }
+        } else {
+            for (int l = 0; l < n; l++) {
+                double rho = temp1*(yp[l] - PHI(l,1)) - PHI(l,16);
+                yy[l] = p[l] + rho;
+                PHI(l,15) = (yy[l] - p[l]) - rho;
+            }
+        }
+        func(x, yy, yp);
+        STAT_COUNT(STAT_DE_FCN);
+
+        //% Update differences for next step
+        for (int l = 0; l < n; l++) {
+            PHI(l,kp1) = yp[l] - PHI(l,1);
+            PHI(l,kp2) = PHI(l,kp1) - PHI(l,kp2);
+        }
+        for (int i = 1; i <= k; i++) {
+            for (int l = 0; l < n; l++) {
+                PHI(l,i) = PHI(l,i) + PHI(l,kp1);
+            }
+        }
+
+        //% Estimate error at order k+1 unless
+        //% - in first phase when always raise order,
+        //% - already decided to lower order,
+        //% - step size not constant so estimate unreliable
+        double erkp1 = 0.0;
+        if (knew == km1 || k == 12) {
+            phase1 = false;
+        }
+        if (phase1) {
+            k = kp1;
+            erk = erkp1;
+        } else if (knew == km1) {
+            //% Lower order
+            k = km1;
+            erk = erkm1;
+        } else if (kp1 <= ns) {
+            for (int l = 0; l < n; l++) {
+                erkp1 += (PHI(l,kp2)/wt[l])*(PHI(l,kp2)/wt[l]);
+            }
+            erkp1 = absh*gstr[kp1]*sqrt(erkp1);
+
+            //% Using estimated error at order k+1, determine
+            //% appropriate order for next step
+            if (k > 1) {
+                if (erkm1 <= fmin(erk, erkp1)) {
+                    k = km1;
+                    erk = erkm1;
+                } else if (erkp1 < erk && k != 12) {
+                    k = kp1;
+                    erk = erkp1;
+                }
+            } else if (erkp1 < 0.5*erk) {
+                k = kp1;
+                erk = erkp1;
+            }
+        }
+        if (k != kold) {
+            STAT_COUNT(STAT_DE_ORDER);
+        }
+
+        //% With new order determine appropriate step size for next step
+        double hnew = 2.0*h;
+        if (!phase1 && p5eps < erk*two[k+1]) {
+            hnew = h;
+            if (p5eps < erk) {
+                double r = pow(p5eps/erk, 1.0/(k+1));
+                hnew = absh*fmax(0.5, fmin(0.9, r));
+                hnew = sign_(fmax(hnew, fouru*fabs(x)), h);
+            }
+        }
+        h = hnew;
+    }
+}
 
 double* DEInteg(double* (*func)(double,double *),double t,double tout,double relerr,double abserr,int n_eqn,double* y);
 
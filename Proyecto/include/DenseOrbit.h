@@ -0,0 +1,28 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_DENSEORBIT_H
+#define PROYECTO_DENSEORBIT_H
+
+#include <vector>
+
+class DenseOrbit {
+public:
+    void clear();
+    void add(double t, const double* Y, const double* dY);
+    void eval(double t, double* Y) const;
+    void addGradient(double t, const double* G);
+    void evalGradient(double t, double* G) const;
+
+    int getNodes() const;
+    double getBegin() const;
+    double getEnd() const;
+    int getGradients() const;
+
+private:
+    std::vector<double> nodes;
+    std::vector<double> grads;
+};
+
+#endif //PROYECTO_DENSEORBIT_H
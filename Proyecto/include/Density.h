@@ -0,0 +1,69 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_DENSITY_H
+#define PROYECTO_DENSITY_H
+
+#include <atomic>
+
+/**
+ * @brief Modelo de densidad atmosférica (interfaz para Harris-Priester, NRLMSISE, ...).
+ */
+class DensityModel {
+public:
+    virtual ~DensityModel() {}
+
+    /**
+     * @brief Densidad atmosférica.
+     *
+     * @param Mjd_TT Época (Terrestrial Time, Modified Julian Date).
+     * @param r_tod Posición del satélite en el sistema verdadero de la fecha [m].
+     * @param r_Sun Posición geocéntrica del Sol en el sistema verdadero de la fecha [m].
+     * @return double Densidad [kg/m^3].
+     */
+    virtual double density(double Mjd_TT, const double* r_tod, const double* r_Sun) const = 0;
+};
+
+class HarrisPriester : public DensityModel {
+public:
+    explicit HarrisPriester(double n_prm = 3.0);
+
+    double density(double Mjd_TT, const double* r_tod, const double* r_Sun) const override;
+
+private:
+    static const int NBIN = 49;         // Altitude bins 100-1000 km
+    static const int NKM = 900;         // 1 km cells of the bin index
+
+    struct Bin {
+        double h0;                      // Lower altitude [km]
+        double ln_min, k_min;           // log(density) at h0 and 1/scale height, minimum
+        double ln_max, k_max;           // Same for the maximum (apex of the bulge)
+    };
+
+    Bin bin[NBIN];
+    unsigned char index[NKM];
+    double half_n;
+};
+
+class CachedDensity : public DensityModel {
+public:
+    CachedDensity(const DensityModel& model, double dt, double dr);
+
+    double density(double Mjd_TT, const double* r_tod, const double* r_Sun) const override;
+    long getCalls() const;
+
+private:
+    struct Slot {
+        unsigned long long id;          // Owner of the slot (0: free)
+        double Mjd_c, r_c[3], rho_c;    // Last evaluation of the owner on this thread
+    };
+    static const int NSLOT = 4;         // Caches remembered per thread
+
+    const DensityModel& model;
+    double dt, dr;
+    unsigned long long id;
+    mutable std::atomic<long> calls;
+};
+
+#endif //PROYECTO_DENSITY_H
@@ -6,9 +6,24 @@
 #define PROYECTO_EKF_GEOS3_H
 
 
-class EKF_GEOS3 {
+#include "RTSSmoother.h"
+#include "Integrator.h"
+#include "ProcessNoise.h"
+#include "Accel.h"
 
+/**
+ * @brief Opciones de `EKF_GEOS3`.
+ */
+struct EKFOptions {
+    RTSSmoother* rts = nullptr;         // Smoother of the extended filter (nullptr: none)
+    bool unscented = false;             // Unscented filter instead of the extended one
+    bool parallel_stm = false;          // STM columns over a dense reference orbit (PropagateSTM)
+    Integrator integ = INTEG_RK;        // Integrator of every propagation
+    const AccelParam* force = nullptr;  // Force model (nullptr: 20x20 field, Sun, Moon and planets)
+    NoiseParam noise = {NOISE_SNC, 1e-12, 0.0};   // Process noise of the time updates
 };
 
+void EKF_GEOS3(const EKFOptions& opt = EKFOptions());
+
 
 #endif //PROYECTO_EKF_GEOS3_H
@@ -0,0 +1,64 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_EVENTS_H
+#define PROYECTO_EVENTS_H
+
+#include <vector>
+#include "MeasModel.h"
+#include "DenseOrbit.h"
+
+struct Event {
+    double t;               // Time since epoch [s]
+    int id;                 // Index of the event function in the detector
+    int direction;          // +1: g crosses zero upwards, -1: downwards
+};
+
+class EventFunction {
+public:
+    virtual ~EventFunction() {}
+    virtual double g(double t, const double* Y) const = 0;
+};
+
+class ElevationEvent : public EventFunction {
+public:
+    ElevationEvent(const MeasModel& model, int station, double Mjd_UT1, double mask);
+    double g(double t, const double* Y) const override;
+
+private:
+    const MeasModel& model;
+    int station;
+    double Mjd_UT1;
+    double mask;
+};
+
+class EclipseEvent : public EventFunction {
+public:
+    explicit EclipseEvent(double Mjd_TT);
+    double g(double t, const double* Y) const override;
+
+private:
+    double Mjd_TT;
+};
+
+class EventDetector {
+public:
+    explicit EventDetector(int nsub = 4, double tol = 1e-3);
+
+    int addEvent(const EventFunction* f);
+    void operator()(double t, const double* Y, const double* dY);
+    void clear();
+
+    const std::vector<Event>& getEvents() const;
+
+private:
+    std::vector<const EventFunction*> functions;
+    std::vector<double> gold;
+    std::vector<Event> events;
+    DenseOrbit step;
+    int nsub;
+    double tol;
+};
+
+#endif //PROYECTO_EVENTS_H
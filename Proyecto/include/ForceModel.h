@@ -0,0 +1,139 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_FORCEMODEL_H
+#define PROYECTO_FORCEMODEL_H
+
+#include <atomic>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "Matrix.h"
+#include "Accel.h"
+#include "SolidTides.h"
+
+/**
+ * @brief Cantidades de una evaluación del modelo de fuerzas compartidas por los contribuyentes.
+ *
+ * La parte de la época (`AccelEpoch`) se calcula una vez y sirve para varios estados;
+ * `setState` fija la posición y la velocidad de cada uno.
+ */
+struct ForceContext {
+    const AccelParam* p;
+    double Mjd_TT;
+    double Mjd_UT1;
+    Matrix T;               // ICRF to true of date (N*P)
+    Matrix E;               // ICRF to Earth-fixed
+    PointMasses bodies;     // Active third bodies
+    double r_Sun[3];        // Geocentric Sun (only if drag, radiation pressure or tides are active)
+    double r_Moon[3];       // Geocentric Moon (only if tides are active)
+    GravityPatch tide;      // Cnm/Snm block with the solid tides (only if tides are active)
+    double r[3];
+    double v[3];
+    double d;               // |r|
+    double rv;              // r.v
+    double v2;              // |v|^2
+
+    ForceContext();
+    void setState(const double* Y);
+};
+
+class ForceModel {
+public:
+    virtual ~ForceModel() {}
+    virtual void accumulate(ForceContext& c, double* a) const = 0;
+    virtual const char* name() const = 0;
+};
+
+class HarmonicForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "Harmonic"; }
+};
+
+class ThirdBodyForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "ThirdBody"; }
+};
+
+class DragForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "Drag"; }
+};
+
+class SolradForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "Solrad"; }
+};
+
+/**
+ * @brief Suma de contribuyentes fijada en tiempo de compilación.
+ *
+ * Las llamadas a los contribuyentes (clases `final`) no son virtuales y se pueden expandir
+ * en línea; es la composición del camino crítico de `Accel`.
+ */
+template <class... F>
+class ForceSum final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override {
+        sum<0>(c, a);
+    }
+    const char* name() const override { return "ForceSum"; }
+
+private:
+    std::tuple<F...> forces;
+
+    template <size_t I>
+    typename std::enable_if<(I < sizeof...(F))>::type sum(ForceContext& c, double* a) const {
+        std::get<I>(forces).accumulate(c, a);
+        sum<I+1>(c, a);
+    }
+    template <size_t I>
+    typename std::enable_if<(I == sizeof...(F))>::type sum(ForceContext&, double*) const {}
+};
+
+/**
+ * @brief Suma de contribuyentes configurada en tiempo de ejecución, con contadores por contribuyente.
+ */
+class ForceRegistry : public ForceModel {
+public:
+    explicit ForceRegistry(bool timing = false);
+
+    int add(const ForceModel& f);
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "ForceRegistry"; }
+
+    int size() const;
+    const ForceModel& get(int i) const;
+    unsigned long long getCalls(int i) const;
+    double getSeconds(int i) const;
+    void resetCounters();
+    void print() const;
+
+private:
+    struct Entry {
+        const ForceModel* f;
+        std::atomic<unsigned long long> calls;
+        std::atomic<unsigned long long> ns;
+    };
+    std::vector<std::unique_ptr<Entry>> entries;
+    bool timing;
+};
+
+class RelativityForce final : public ForceModel {
+public:
+    void accumulate(ForceContext& c, double* a) const override;
+    const char* name() const override { return "Relativity"; }
+};
+
+typedef ForceSum<HarmonicForce, ThirdBodyForce, DragForce, SolradForce, RelativityForce> StandardForces;
+
+void AccelEpoch(double x, const AccelParam& p, ForceContext& c);
+void Accel(double x, const double* Y, double* dY, const AccelParam& p, const ForceModel& forces);
+
+#endif //PROYECTO_FORCEMODEL_H
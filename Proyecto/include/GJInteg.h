@@ -0,0 +1,132 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_GJINTEG_H
+#define PROYECTO_GJINTEG_H
+
+#include <cmath>
+#include <vector>
+#include "RKInteg.h"
+
+/**
+ * @brief Coeficientes de la forma sumada de Gauss-Jackson de orden 8 (9 puntos).
+ */
+struct GJ8 {
+    static constexpr int NB = 9;    // Number of back points (order + 1)
+    static const double d[7];
+    static const double g[7];
+    static const double e[8];
+    static const double q[8];
+};
+
+/**
+ * @brief Integra r'' = a(t,r,v) con el método de Gauss-Jackson de orden 8.
+ *
+ * @param func Invocable func(t, y, dy) que escribe [v;a] en dy, como `Accel`.
+ * @param t Instante inicial.
+ * @param tout Instante final (puede ser anterior a t).
+ * @param h Paso nominal [s]; se ajusta para que un número entero de pasos llegue a tout.
+ * @param n_eqn Número de ecuaciones (posiciones seguidas de velocidades).
+ * @param y Estado [r;v] en t (entrada) y en tout (salida).
+ * @return double* Puntero a y.
+ *
+ * @details
+ * Los puntos de arranque se calculan con `RKInteg` y con tolerancias estrictas. Si el
+ * intervalo no admite más pasos que los de arranque, se integra entero con `RKInteg`.
+ */
+template <class F>
+double* GJInteg(F&& func,double t,double tout,double h,int n_eqn,double* y) {
+
+    int n = n_eqn/2;
+    int nstep = (int) ceil(fabs(tout - t)/fabs(h) - 1e-9);
+    if (nstep <= GJ8::NB) {
+        return RKInteg(func,t,tout,1e-13,1e-9,n_eqn,y);
+    }
+    h = (tout - t)/nstep;
+
+    //% Start-up: states and accelerations at t, t+h, ..., t+8h (ring buffer)
+    const int NB = GJ8::NB;
+    const double* d = GJ8::d;
+    const double* g = GJ8::g;
+    const double* e = GJ8::e;
+    const double* q = GJ8::q;
+    std::vector<double> acc(NB*n), s1(n), s2(n), s2old(n), rp(2*n), f(n_eqn);
+    for (int j = 0; j < NB; j++) {
+        if (j == NB-1) {
+            for (int i = 0; i < n; i++) {
+                rp[i] = y[i];
+            }
+        }
+        if (j > 0) {
+            RKInteg(func,t+(j-1)*h,t+j*h,1e-13,1e-9,n_eqn,y);
+        }
+        func(t+j*h, y, f.data());
+        for (int i = 0; i < n; i++) {
+            acc[n*j+i] = f[n+i];
+        }
+    }
+    int cur = NB-1;     // Ring index of a(n)
+    auto A = [&](int k, int i) -> double& { return acc[n*((cur-k+NB)%NB)+i]; };
+
+    //% Initialise the sums from the corrector relations at the last two points
+    double h2 = h*h;
+    for (int i = 0; i < n; i++) {
+        double sg = 0.0, sgold = 0.0, sq = 0.0;
+        for (int k = 0; k < 7; k++) {
+            sg += g[k]*A(k,i);
+            sgold += g[k]*A(k+1,i);
+        }
+        for (int k = 0; k < 8; k++) {
+            sq += q[k]*A(k,i);
+        }
+        s2[i] = y[i]/h2 - sg;
+        s2old[i] = rp[i]/h2 - sgold;
+        s1[i] = y[n+i]/h - sq;
+    }
+
+    //% PEC steps
+    for (int step = NB-1; step < nstep; step++) {
+        //% Predict
+        for (int i = 0; i < n; i++) {
+            double s2new = 2.0*s2[i] - s2old[i] + A(0,i);
+            s2old[i] = s2[i];
+            s2[i] = s2new;
+            s1[i] += A(0,i);
+            double sd = 0.0, se = 0.0;
+            for (int k = 0; k < 7; k++) {
+                sd += d[k]*A(k,i);
+            }
+            for (int k = 0; k < 8; k++) {
+                se += e[k]*A(k,i);
+            }
+            rp[i] = h2*(s2[i] + sd);
+            rp[n+i] = h*(s1[i] + se);
+        }
+        //% Evaluate
+        func(t+(step+1)*h, rp.data(), f.data());
+        cur = (cur+1)%NB;
+        for (int i = 0; i < n; i++) {
+            A(0,i) = f[n+i];
+        }
+
+        //% Correct
+        for (int i = 0; i < n; i++) {
+            double sg = 0.0, sq = 0.0;
+            for (int k = 0; k < 7; k++) {
+                sg += g[k]*A(k,i);
+            }
+            for (int k = 0; k < 8; k++) {
+                sq += q[k]*A(k,i);
+            }
+            y[i] = h2*(s2[i] + sg);
+            y[n+i] = h*(s1[i] + sq);
+        }
+    }
+    return y;
+}
+
+double* GJInteg(double* (*func)(double,double *),double t,double tout,double h,int n_eqn,double* y);
+
+
+#endif //PROYECTO_GJINTEG_H
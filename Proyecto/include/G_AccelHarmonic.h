@@ -8,7 +8,7 @@
 
 #include "Matrix.h"
 
-Matrix G_AccelHarmonic(double* r, Matrix U, int n_max, int m_max );
+Matrix G_AccelHarmonic(double* r, const Matrix& U, int n_max, int m_max );
 
 
 #endif //PROYECTO_G_ACCELHARMONIC_H
@@ -0,0 +1,33 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_GRAVITYGRID_H
+#define PROYECTO_GRAVITYGRID_H
+
+#include <vector>
+#include "Matrix.h"
+
+class GravityGrid {
+public:
+    GravityGrid(int n_max, int m_max, double r_min, double r_max, int nr, int nlat, int nlon, int nthreads = 0);
+    explicit GravityGrid(const char* path);
+
+    void save(const char* path) const;
+    bool contains(double d) const;
+    void perturbation(const double* r_bf, double* a_bf) const;
+    bool accel(const double* r, Matrix& E, double* a) const;
+    double maxError(int nsample) const;
+
+    int getDegree() const;
+    int getOrder() const;
+
+private:
+    int n_max, m_max;
+    int nr, nlat, nlon;
+    double r_min, r_max;
+    double dr, dlat, dlon;
+    std::vector<double> table;
+};
+
+#endif //PROYECTO_GRAVITYGRID_H
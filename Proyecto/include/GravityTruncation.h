@@ -0,0 +1,24 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_GRAVITYTRUNCATION_H
+#define PROYECTO_GRAVITYTRUNCATION_H
+
+#include <vector>
+#include "Matrix.h"
+
+class GravityTruncation {
+public:
+    GravityTruncation(const Matrix& Cnm, const Matrix& Snm, double tol);
+
+    int degree(double d, int n_max) const;
+    double tail(double d, int n, int n_max) const;
+    double getTol() const;
+
+private:
+    std::vector<double> power;
+    double tol;
+};
+
+#endif //PROYECTO_GRAVITYTRUNCATION_H
@@ -0,0 +1,40 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_INTEGRATOR_H
+#define PROYECTO_INTEGRATOR_H
+
+#include "DEInteg.h"
+#include "RKInteg.h"
+
+/**
+ * @brief Integrador de las propagaciones de los filtros y del ajuste por mínimos cuadrados.
+ */
+enum Integrator {
+    INTEG_DE,               // Shampine & Gordon multistep (DEInteg)
+    INTEG_RK                // Dormand & Prince 8(5,3) (RKInteg)
+};
+
+/**
+ * @brief Integra un sistema de ecuaciones diferenciales con el integrador elegido.
+ *
+ * @param integ Integrador.
+ * @param func Invocable func(t, y, dy) que escribe la derivada dy/dt en dy.
+ * @param t Instante inicial.
+ * @param tout Instante final (puede ser anterior a t).
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @param n_eqn Número de ecuaciones.
+ * @param y Estado en t (entrada) y en tout (salida).
+ * @return double* Puntero a y.
+ */
+template <class F>
+double* Integrate(Integrator integ,F&& func,double t,double tout,double relerr,double abserr,int n_eqn,double* y) {
+    if (integ == INTEG_DE) {
+        return DEInteg(func,t,tout,relerr,abserr,n_eqn,y);
+    }
+    return RKInteg(func,t,tout,relerr,abserr,n_eqn,y);
+}
+
+#endif //PROYECTO_INTEGRATOR_H
@@ -0,0 +1,50 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_MEASMODEL_H
+#define PROYECTO_MEASMODEL_H
+
+#include <vector>
+#include "Matrix.h"
+
+enum MEAS_TYPE {
+    MEAS_AZIMUTH = 0,     // Azimuth [rad]
+    MEAS_ELEVATION = 1,   // Elevation [rad]
+    MEAS_RANGE = 2        // Range [m]
+};
+
+struct Station {
+    double lon, lat, alt;   // Geodetic coordinates [rad, rad, m]
+    double Rs[3];           // Body-fixed position [m]
+    double LT[3][3];        // Local tangent coordinates matrix
+    double sigma[3];        // Standard deviation of azimuth, elevation and range
+};
+
+struct Observation {
+    double Mjd_UTC;
+    int station;
+    MEAS_TYPE type;
+    double value;
+};
+
+struct MeasPrediction {
+    double s[3];            // Topocentric position [m]
+    double value[3];        // Azimuth, elevation and range
+    double dzdY[3][6];      // Partials w.r.t. the state vector (MEAS_TYPE row)
+};
+
+class MeasModel {
+public:
+    int addStation(double lon, double lat, double alt,
+                   double sigma_az, double sigma_el, double sigma_range);
+    int getStations() const;
+    const Station& getStation(int k) const;
+
+    void predict(int k, Matrix& U, const double* r, MeasPrediction& pred) const;
+
+private:
+    std::vector<Station> stations;
+};
+
+#endif //PROYECTO_MEASMODEL_H
@@ -0,0 +1,31 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_PROCESSNOISE_H
+#define PROYECTO_PROCESSNOISE_H
+
+#include "Matrix.h"
+
+/**
+ * @brief Modelo de ruido del proceso de los filtros.
+ */
+enum NoiseModel {
+    NOISE_NONE,             // No process noise
+    NOISE_SNC,              // White acceleration noise (state noise compensation)
+    NOISE_DMC               // Gauss-Markov acceleration estimated in the state (dynamic model compensation)
+};
+
+struct NoiseParam {
+    NoiseModel model;
+    double q;               // Spectral density [m^2/s^3] (SNC) or [m^2/s^5] (DMC)
+    double tau;             // Correlation time [s] (DMC)
+};
+
+Matrix SNCNoise(double dt, double q);
+Matrix DMCNoise(double dt, double tau, double q);
+Matrix DMCTransition(double dt, double tau);
+Matrix NoiseMatrix(const NoiseParam& noise, double dt);
+Matrix DMCTimeUpdate(double* Y, Matrix& P, const Matrix& Phi, double dt, double tau, double q);
+
+#endif //PROYECTO_PROCESSNOISE_H
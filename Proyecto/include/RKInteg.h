@@ -0,0 +1,316 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_RKINTEG_H
+#define PROYECTO_RKINTEG_H
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include "sign_.h"
+#include "Stats.h"
+
+/**
+ * @brief Coeficientes del método de Dormand & Prince de orden 8(5,3) (DOP853).
+ */
+struct DOP853 {
+    static constexpr double c2  = 0.526001519587677318785587544488e-01;
+    static constexpr double c3  = 0.789002279381515978178381316732e-01;
+    static constexpr double c4  = 0.118350341907227396726757197510;
+    static constexpr double c5  = 0.281649658092772603273242802490;
+    static constexpr double c6  = 0.333333333333333333333333333333;
+    static constexpr double c7  = 0.25;
+    static constexpr double c8  = 0.307692307692307692307692307692;
+    static constexpr double c9  = 0.651282051282051282051282051282;
+    static constexpr double c10 = 0.6;
+    static constexpr double c11 = 0.857142857142857142857142857142;
+
+    static constexpr double a21 =  5.26001519587677318785587544488e-2;
+    static constexpr double a31 =  1.97250569845378994544595329183e-2;
+    static constexpr double a32 =  5.91751709536136983633785987549e-2;
+    static constexpr double a41 =  2.95875854768068491816892993775e-2;
+    static constexpr double a43 =  8.87627564304205475450678981324e-2;
+    static constexpr double a51 =  2.41365134159266685502369798665e-1;
+    static constexpr double a53 = -8.84549479328286085344864962717e-1;
+    static constexpr double a54 =  9.24834003261792003115737966543e-1;
+    static constexpr double a61 =  3.7037037037037037037037037037e-2;
+    static constexpr double a64 =  1.70828608729473871279604482173e-1;
+    static constexpr double a65 =  1.25467687566822425016691814123e-1;
+    static constexpr double a71 =  3.7109375e-2;
+    static constexpr double a74 =  1.70252211019544039314978060272e-1;
+    static constexpr double a75 =  6.02165389804559606850219397283e-2;
+    static constexpr double a76 = -1.7578125e-2;
+    static constexpr double a81 =  3.70920001185047927108779319836e-2;
+    static constexpr double a84 =  1.70383925712239993810214054705e-1;
+    static constexpr double a85 =  1.07262030446373284651809199168e-1;
+    static constexpr double a86 = -1.53194377486244017527936158236e-2;
+    static constexpr double a87 =  8.27378916381402288758473766002e-3;
+    static constexpr double a91 =  6.24110958716075717114429577812e-1;
+    static constexpr double a94 = -3.36089262944694129406857109825;
+    static constexpr double a95 = -8.68219346841726006818189891453e-1;
+    static constexpr double a96 =  2.75920996994467083049415600797e1;
+    static constexpr double a97 =  2.01540675504778934086186788979e1;
+    static constexpr double a98 = -4.34898841810699588477366255144e1;
+    static constexpr double a101 =  4.77662536438264365890433908527e-1;
+    static constexpr double a104 = -2.48811461997166764192642586468;
+    static constexpr double a105 = -5.90290826836842996371446475743e-1;
+    static constexpr double a106 =  2.12300514481811942347288949897e1;
+    static constexpr double a107 =  1.52792336328824235832596922938e1;
+    static constexpr double a108 = -3.32882109689848629194453265587e1;
+    static constexpr double a109 = -2.03312017085086261358222928593e-2;
+    static constexpr double a111 = -9.3714243008598732571704021658e-1;
+    static constexpr double a114 =  5.18637242884406370830023853209;
+    static constexpr double a115 =  1.09143734899672957818500254654;
+    static constexpr double a116 = -8.14978701074692612513997267357;
+    static constexpr double a117 = -1.85200656599969598641566180701e1;
+    static constexpr double a118 =  2.27394870993505042818970056734e1;
+    static constexpr double a119 =  2.49360555267965238987089396762;
+    static constexpr double a1110 = -3.0467644718982195003823669022;
+    static constexpr double a121 =  2.27331014751653820792359768449;
+    static constexpr double a124 = -1.05344954667372501984066689879e1;
+    static constexpr double a125 = -2.00087205822486249909675718444;
+    static constexpr double a126 = -1.79589318631187989172765950534e1;
+    static constexpr double a127 =  2.79488845294199600508499808837e1;
+    static constexpr double a128 = -2.85899827713502369474065508674;
+    static constexpr double a129 = -8.87285693353062954433549289258;
+    static constexpr double a1210 =  1.23605671757943030647266201528e1;
+    static constexpr double a1211 =  6.43392746015763530355970484046e-1;
+
+    static constexpr double b1  =  5.42937341165687622380535766363e-2;
+    static constexpr double b6  =  4.45031289275240888144113950566;
+    static constexpr double b7  =  1.89151789931450038304281599044;
+    static constexpr double b8  = -5.8012039600105847814672114227;
+    static constexpr double b9  =  3.1116436695781989440891606237e-1;
+    static constexpr double b10 = -1.52160949662516078556178806805e-1;
+    static constexpr double b11 =  2.01365400804030348374776537501e-1;
+    static constexpr double b12 =  4.47106157277725905176885569043e-2;
+
+    static constexpr double bhh1 = 0.244094488188976377952755905512;
+    static constexpr double bhh2 = 0.733846688281611857341361741547;
+    static constexpr double bhh3 = 0.220588235294117647058823529412e-01;
+
+    static constexpr double er1  =  0.1312004499419488073250102996e-01;
+    static constexpr double er6  = -0.1225156446376204440720569753e+01;
+    static constexpr double er7  = -0.4957589496572501915214079952;
+    static constexpr double er8  =  0.1664377182454986536961530415e+01;
+    static constexpr double er9  = -0.3503288487499736816886487290;
+    static constexpr double er10 =  0.3341791187130174790297318841;
+    static constexpr double er11 =  0.8192320648511571246570742613e-01;
+    static constexpr double er12 = -0.2235530786388629525884427845e-01;
+};
+
+/**
+ * @brief Buffers de las etapas del integrador.
+ *
+ * Se reservan una vez por hilo y nivel de anidamiento y se reutilizan mientras no cambie
+ * el número de ecuaciones, de modo que los intervalos cortos entre observaciones no
+ * reservan memoria.
+ */
+struct RKWork {
+    int n = 0;
+    std::vector<double> buf;
+    double *k1, *k2, *k3, *k4, *k5, *k6, *k7, *k8, *k9, *k10, *y1, *yt;
+
+    void resize(int n_eqn);
+};
+
+/**
+ * @brief Buffers de una llamada a `RKInteg`, tomados de la pila del hilo actual.
+ *
+ * Una integración lanzada desde func u observer recibe los buffers del siguiente nivel,
+ * así que no pisa los de la llamada exterior.
+ */
+class RKWorkScope {
+public:
+    explicit RKWorkScope(int n_eqn);
+    ~RKWorkScope();
+    RKWorkScope(const RKWorkScope&) = delete;
+    RKWorkScope& operator=(const RKWorkScope&) = delete;
+
+    RKWork& w;
+};
+
+/**
+ * @brief Integra un sistema de ecuaciones diferenciales ordinarias con el método DOP853.
+ *
+ * Misma semántica de tolerancias que `DEInteg`: el error local de cada componente se
+ * mantiene por debajo de `relerr*|y_i| + abserr`.
+ *
+ * @param func Invocable func(t, y, dy) que escribe la derivada dy/dt en dy.
+ * @param t Instante inicial.
+ * @param tout Instante final (puede ser anterior a t).
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @param n_eqn Número de ecuaciones.
+ * @param y Estado en t (entrada) y en tout (salida).
+ * @param nblock Si es mayor que 0, el vector se trata como bloques independientes de nblock
+ * componentes y el error del paso es el máximo de los errores de cada bloque (propagación
+ * conjunta de varios estados con un único paso).
+ * @param observer Invocable observer(t, y, dy) llamado en el instante inicial y tras cada
+ * paso aceptado, con el estado y su derivada (salida densa).
+ * @return double* Puntero a y.
+ * @throws std::runtime_error Si el paso se hace demasiado pequeño o se supera el número máximo de pasos.
+ */
+template <class F, class O>
+double* RKInteg(F&& func,double t,double tout,double relerr,double abserr,int n_eqn,double* y,int nblock,O&& observer) {
+
+    typedef DOP853 C;
+    const double uround = 2.3e-16;
+    const double safe = 0.9, facc1 = 1.0/0.333, facc2 = 1.0/6.0;
+    const int nmax = 100000;
+
+    if (tout == t) {
+        return y;
+    }
+    RKWorkScope scope(n_eqn);
+    RKWork& w = scope.w;
+    int n = n_eqn;
+    double posneg = sign_(1.0, tout - t);
+    double hmax = fabs(tout - t);
+
+    //% FSAL: derivative at the initial point, first stage of the first step
+    func(t, y, w.k1);
+    observer(t, y, w.k1);
+
+    //% Initial step size (Hairer & Wanner, HINIT)
+    double dnf = 0.0, dny = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sk = abserr + relerr*fabs(y[i]);
+        dnf += (w.k1[i]/sk)*(w.k1[i]/sk);
+        dny += (y[i]/sk)*(y[i]/sk);
+    }
+    double h = (dnf <= 1e-10 || dny <= 1e-10) ? 1.0e-6 : sqrt(dny/dnf)*0.01;
+    h = fmin(h, hmax)*posneg;
+    for (int i = 0; i < n; i++) {
+        w.k3[i] = y[i] + h*w.k1[i];
+    }
+    func(t + h, w.k3, w.k2);
+    STAT_ADD(STAT_RK_FCN, 2);
+    double der2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sk = abserr + relerr*fabs(y[i]);
+        der2 += ((w.k2[i]-w.k1[i])/sk)*((w.k2[i]-w.k1[i])/sk);
+    }
+    der2 = sqrt(der2)/fabs(h);
+    double der12 = fmax(der2, sqrt(dnf));
+    double h1 = (der12 <= 1e-15) ? fmax(1.0e-6, fabs(h)*1.0e-3) : pow(0.01/der12, 1.0/8.0);
+    h = fmin(fmin(100.0*fabs(h), h1), hmax)*posneg;
+
+    double x = t;
+    bool reject = false;
+
+    for (int nstep = 0; ; nstep++) {
+        if (nstep > nmax) {
+            throw std::runtime_error("RKInteg: maximum number of steps exceeded");
+        }
+        if (0.1*fabs(h) <= fabs(x)*uround) {
+            throw std::runtime_error("RKInteg: step size too small");
+        }
+        bool last = false;
+        if ((x + 1.01*h - tout)*posneg > 0.0) {
+            h = tout - x;
+            last = true;
+        }
+
+        //% The twelve stages
+        double* k1 = w.k1; double* k2 = w.k2; double* k3 = w.k3; double* k4 = w.k4;
+        double* k5 = w.k5; double* k6 = w.k6; double* k7 = w.k7; double* k8 = w.k8;
+        double* k9 = w.k9; double* k10 = w.k10; double* y1 = w.y1; double* yt = w.yt;
+
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*C::a21*k1[i];
+        func(x + C::c2*h, y1, k2);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a31*k1[i] + C::a32*k2[i]);
+        func(x + C::c3*h, y1, k3);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a41*k1[i] + C::a43*k3[i]);
+        func(x + C::c4*h, y1, k4);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a51*k1[i] + C::a53*k3[i] + C::a54*k4[i]);
+        func(x + C::c5*h, y1, k5);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a61*k1[i] + C::a64*k4[i] + C::a65*k5[i]);
+        func(x + C::c6*h, y1, k6);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a71*k1[i] + C::a74*k4[i] + C::a75*k5[i] + C::a76*k6[i]);
+        func(x + C::c7*h, y1, k7);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a81*k1[i] + C::a84*k4[i] + C::a85*k5[i] + C::a86*k6[i] + C::a87*k7[i]);
+        func(x + C::c8*h, y1, k8);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a91*k1[i] + C::a94*k4[i] + C::a95*k5[i] + C::a96*k6[i] + C::a97*k7[i] + C::a98*k8[i]);
+        func(x + C::c9*h, y1, k9);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a101*k1[i] + C::a104*k4[i] + C::a105*k5[i] + C::a106*k6[i] + C::a107*k7[i] + C::a108*k8[i] + C::a109*k9[i]);
+        func(x + C::c10*h, y1, k10);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a111*k1[i] + C::a114*k4[i] + C::a115*k5[i] + C::a116*k6[i] + C::a117*k7[i] + C::a118*k8[i] + C::a119*k9[i] + C::a1110*k10[i]);
+        func(x + C::c11*h, y1, k2);
+        for (int i = 0; i < n; i++) y1[i] = y[i] + h*(C::a121*k1[i] + C::a124*k4[i] + C::a125*k5[i] + C::a126*k6[i] + C::a127*k7[i] + C::a128*k8[i] + C::a129*k9[i] + C::a1210*k10[i] + C::a1211*k2[i]);
+        func(x + h, y1, k3);
+        STAT_ADD(STAT_RK_FCN, 11);
+
+        //% 8th order solution (k4 holds the weighted slope) and error estimate
+        int nb = nblock > 0 ? nblock : n;
+        double errmax = 0.0;
+        for (int i0 = 0; i0 < n; i0 += nb) {
+            double err = 0.0, err2 = 0.0;
+            for (int i = i0; i < i0+nb; i++) {
+                k4[i] = C::b1*k1[i] + C::b6*k6[i] + C::b7*k7[i] + C::b8*k8[i] + C::b9*k9[i] + C::b10*k10[i] + C::b11*k2[i] + C::b12*k3[i];
+                yt[i] = y[i] + h*k4[i];
+                double sk = abserr + relerr*fmax(fabs(y[i]), fabs(yt[i]));
+                double erri = k4[i] - C::bhh1*k1[i] - C::bhh2*k9[i] - C::bhh3*k3[i];
+                err2 += (erri/sk)*(erri/sk);
+                erri = C::er1*k1[i] + C::er6*k6[i] + C::er7*k7[i] + C::er8*k8[i] + C::er9*k9[i] + C::er10*k10[i] + C::er11*k2[i] + C::er12*k3[i];
+                err += (erri/sk)*(erri/sk);
+            }
+            double deno = err + 0.01*err2;
+            if (deno <= 0.0) {
+                deno = 1.0;
+            }
+            errmax = fmax(errmax, fabs(h)*err*sqrt(1.0/(nb*deno)));
+        }
+        double err = errmax;
+
+        //% Step size control
+        double fac11 = pow(err, 1.0/8.0);
+        double fac = fmax(facc2, fmin(facc1, fac11/safe));
+        double hnew = h/fac;
+
+        if (err <= 1.0) {
+            //% Step accepted; the last stage derivative is reused (FSAL)
+            func(x + h, yt, k4);
+            STAT_COUNT(STAT_RK_FCN);
+            STAT_COUNT(STAT_RK_STEPS);
+            for (int i = 0; i < n; i++) {
+                k1[i] = k4[i];
+                y[i] = yt[i];
+            }
+            x += h;
+            observer(x, y, k1);
+            if (last) {
+                return y;
+            }
+            if (fabs(hnew) > hmax) {
+                hnew = posneg*hmax;
+            }
+            if (reject) {
+                hnew = posneg*fmin(fabs(hnew), fabs(h));
+            }
+            reject = false;
+        } else {
+            //% Step rejected
+            STAT_COUNT(STAT_RK_REJECTED);
+            hnew = h/fmin(facc1, fac11/safe);
+            reject = true;
+        }
+        h = hnew;
+    }
+}
+
+/**
+ * @brief Integra un sistema de ecuaciones diferenciales ordinarias con el método DOP853.
+ *
+ * @see RKInteg(F&&,double,double,double,double,int,double*,int,O&&)
+ */
+template <class F>
+double* RKInteg(F&& func,double t,double tout,double relerr,double abserr,int n_eqn,double* y,int nblock = 0) {
+    return RKInteg(func,t,tout,relerr,abserr,n_eqn,y,nblock,[](double, const double*, const double*) {});
+}
+
+double* RKInteg(double* (*func)(double,double *),double t,double tout,double relerr,double abserr,int n_eqn,double* y);
+
+
+#endif //PROYECTO_RKINTEG_H
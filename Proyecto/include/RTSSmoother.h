@@ -0,0 +1,35 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_RTSSMOOTHER_H
+#define PROYECTO_RTSSMOOTHER_H
+
+#include <vector>
+#include "Matrix.h"
+
+class RTSSmoother {
+public:
+    static const int NMAX = 9;          // Largest state dimension
+
+    explicit RTSSmoother(int capacity, int nstate = 6);
+
+    void storePrediction(double Mjd_UTC, const double* Y_pred, Matrix& P_pred, Matrix& Phi);
+    void storeUpdate(const double* Y_filt, Matrix& P_filt);
+    void smooth();
+
+    int getEpochs() const;
+    int getStates() const;
+    double getMjd(int k) const;
+    void getState(int k, double* Y) const;
+    void getCovariance(int k, Matrix& P) const;
+
+private:
+    std::vector<double> arena;
+    int nepoch;
+    int n;                              // State dimension
+    int rec_size;                       // Doubles per checkpoint
+    int off_yp, off_pp, off_phi, off_yf, off_pf;
+};
+
+#endif //PROYECTO_RTSSMOOTHER_H
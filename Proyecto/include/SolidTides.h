@@ -0,0 +1,96 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_SOLIDTIDES_H
+#define PROYECTO_SOLIDTIDES_H
+
+/**
+ * @brief Copia corregida del bloque de grado bajo de Cnm/Snm (índices base 0: C[n][m]).
+ */
+struct GravityPatch {
+    static const int NMAX = 4;
+    int n;                              // Highest patched degree (-1: none)
+    double C[NMAX+1][NMAX+1];
+    double S[NMAX+1][NMAX+1];
+
+    GravityPatch();
+    void set(const double dC[NMAX+1][NMAX+1], const double dS[NMAX+1][NMAX+1]);
+};
+
+#include <cmath>
+#include "Matrix.h"
+
+void SolidTides(const double* r_Sun_bf, const double* r_Moon_bf, double dC[5][5], double dS[5][5]);
+void AccelPatch(const double* r, Matrix& E, const GravityPatch& patch, double* a);
+
+/**
+ * @brief Correcciones de marea interpoladas linealmente entre nodos equiespaciados en UTC.
+ *
+ * Los nodos están en t_k = k*step (segundos UTC desde MJD 0), de modo que el bloque
+ * devuelto sólo depende de la época y no del orden de las llamadas ni del hilo.
+ */
+struct TideCache {
+    double step;                        // Spacing of the nodes [s]
+    long long k[2];                     // Cached nodes, slot k % 2 (-1: empty)
+    double dC[2][5][5];
+    double dS[2][5][5];
+    GravityPatch patch;
+    unsigned long long evaluations;     // Calls to SolidTides
+
+    TideCache();
+    template <class F>
+    const GravityPatch& get(double Mjd_UTC, double step, F&& bodies);
+
+private:
+    template <class F>
+    int node(long long kn, F&& bodies);
+};
+
+/**
+ * @brief Bloque corregido por mareas en una época, interpolado entre los dos nodos que la rodean.
+ *
+ * @param Mjd_UTC Época (UTC, Modified Julian Date).
+ * @param h Separación de los nodos [s] (> 0).
+ * @param bodies bodies(Mjd_UTC, s_bf, m_bf): posiciones del Sol y la Luna en el sistema ligado
+ * a la Tierra en un nodo; sólo se llama para los nodos que no están guardados.
+ * @return const GravityPatch& Bloque corregido (válido hasta la siguiente llamada).
+ */
+template <class F>
+const GravityPatch& TideCache::get(double Mjd_UTC, double h, F&& bodies) {
+    if (h != step) {
+        step = h;
+        k[0] = -1;
+        k[1] = -1;
+    }
+    double s = Mjd_UTC*86400.0/step;
+    long long k0 = (long long) floor(s);
+    double w = s - k0;
+    int i0 = node(k0, bodies);
+    int i1 = node(k0+1, bodies);
+
+    double dCi[5][5], dSi[5][5];
+    for (int n = 0; n < 5; n++) {
+        for (int m = 0; m < 5; m++) {
+            dCi[n][m] = (1.0-w)*dC[i0][n][m] + w*dC[i1][n][m];
+            dSi[n][m] = (1.0-w)*dS[i0][n][m] + w*dS[i1][n][m];
+        }
+    }
+    patch.set(dCi, dSi);
+    return patch;
+}
+
+template <class F>
+int TideCache::node(long long kn, F&& bodies) {
+    int i = (int) (kn % 2);
+    if (k[i] != kn) {
+        double s_bf[3], m_bf[3];
+        bodies(kn*step/86400.0, s_bf, m_bf);
+        SolidTides(s_bf, m_bf, dC[i], dS[i]);
+        k[i] = kn;
+        evaluations++;
+    }
+    return i;
+}
+
+#endif //PROYECTO_SOLIDTIDES_H
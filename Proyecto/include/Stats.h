@@ -0,0 +1,59 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_STATS_H
+#define PROYECTO_STATS_H
+
+enum StatCounter {
+    STAT_DE_STEPS,          // DEInteg: accepted steps
+    STAT_DE_REJECTED,       // DEInteg: rejected steps
+    STAT_DE_ORDER,          // DEInteg: order changes
+    STAT_DE_FCN,            // DEInteg: calls to func
+    STAT_RK_STEPS,          // RKInteg: accepted steps
+    STAT_RK_REJECTED,       // RKInteg: rejected steps
+    STAT_RK_FCN,            // RKInteg: calls to func
+    STAT_ACCEL,             // Accel: calls
+    STAT_NCOUNTER
+};
+
+enum StatTimer {
+    TIMER_IERS,             // Accel: IERS and timediff
+    TIMER_FRAMES,           // Accel: precession, nutation, pole and GHA matrices
+    TIMER_JPL,              // Accel: JPL_Eph_DE430
+    TIMER_HARMONIC,         // Accel: AccelHarmonic
+    TIMER_POINTMASS,        // Accel: AccelPointMass
+    TIMER_DRAG,             // Accel: AccelDrag
+    TIMER_SOLRAD,           // Accel: Shadow and AccelSolrad
+    STAT_NTIMER
+};
+
+struct Stats {
+    unsigned long long count[STAT_NCOUNTER];
+    unsigned long long ticks[STAT_NTIMER];
+};
+
+void StatsReset();
+void StatsTotal(Stats& s);
+void StatsPrint();
+
+#ifdef PROYECTO_STATS
+
+Stats& ThreadStats();
+unsigned long long StatsClock();
+
+#define STAT_COUNT(c) (ThreadStats().count[c]++)
+#define STAT_ADD(c, k) (ThreadStats().count[c] += (k))
+#define STAT_TIMER_START(t) const unsigned long long stat_t0_##t = StatsClock()
+#define STAT_TIMER_STOP(t) (ThreadStats().ticks[t] += StatsClock() - stat_t0_##t)
+
+#else
+
+#define STAT_COUNT(c) ((void) 0)
+#define STAT_ADD(c, k) ((void) 0)
+#define STAT_TIMER_START(t) ((void) 0)
+#define STAT_TIMER_STOP(t) ((void) 0)
+
+#endif
+
+#endif //PROYECTO_STATS_H
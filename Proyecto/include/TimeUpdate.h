@@ -8,5 +8,6 @@
 #include "Matrix.h"
 
 void TimeUpdate(Matrix& P, Matrix Phi, double Qdt = 0.0);
+void TimeUpdate(Matrix& P, Matrix Phi, Matrix Qdt);
 
 #endif //PROYECTO_TIMEUPDATE_H
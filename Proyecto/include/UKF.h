@@ -0,0 +1,18 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#ifndef PROYECTO_UKF_H
+#define PROYECTO_UKF_H
+
+#include "Matrix.h"
+#include "MeasModel.h"
+#include "Integrator.h"
+#include "Accel.h"
+
+void SigmaPoints(const double* Y, Matrix& P, double* X, double* Wm, double* Wc);
+void UKFTimeUpdate(double* Y, Matrix& P, double dt, const AccelParam& p, int nthreads = 0,
+                   Integrator integ = INTEG_RK);
+void UKFMeasUpdate(double* Y, Matrix& P, MeasModel& model, Matrix& U, const Observation* obs, int nz);
+
+#endif //PROYECTO_UKF_H
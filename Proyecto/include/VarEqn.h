@@ -6,7 +6,27 @@
 #define PROYECTO_VAREQN_H
 
 
+#include "Accel.h"
+#include "Matrix.h"
+#include "DenseOrbit.h"
+
+/**
+ * @brief Término forzado de las columnas de sensibilidad frente a parámetros.
+ */
+class SensitivityForcing {
+public:
+    virtual ~SensitivityForcing() {}
+    virtual void dadp(double t, const double* Y, int col, double* da) const = 0;
+};
+
+void VarEqn(double x, const double* yPhi, double* yPhip, const AccelParam& p);
 double* VarEqn(double x,double* yPhi);
+Matrix VarEqnFrame(double x, const AccelParam& p);
+void VarEqnGradient(double x, const double* r, const AccelParam& p, double* G);
+void VarEqnColumns(const DenseOrbit& ref, double t, double tout, Matrix& S,
+                   const SensitivityForcing* forcing = nullptr, int nthreads = 1,
+                   double relerr = 1e-13, double abserr = 1e-6);
+void PropagateSTM(double t, double tout, double* Y, Matrix& Phi, const AccelParam& p, int nthreads = 1);
 
 
 #endif //PROYECTO_VAREQN_H
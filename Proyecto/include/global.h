@@ -23,8 +23,11 @@ public:
     static int sun;
     static int moon;
     static int planets;
+    static int relativity;
     static void eop19620101();
     static void GGM03S();
+    static void GGM03S(int nmax);
+    static void GGM03S_bin(const char* path);
     static void GEOS3(int nobs);
     static void DE430Coeff();
     static void AuxParam();
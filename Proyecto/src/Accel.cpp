@@ -2,6 +2,7 @@
 // Created by adboudja on 16/05/2024.
 //
 
+#include <cmath>
 #include "Accel.h"
 #include "Matrix.h"
 #include "global.h"
@@ -14,9 +15,11 @@
 #include "PrecMatrix.h"
 #include "Mjday_TDB.h"
 #include "JPL_Eph_DE430.h"
-#include "AccelHarmonic.h"
-#include "AccelPointMass.h"
 #include "auxFunc.h"
+#include "Stats.h"
+#include "ForceModel.h"
+#include "SolidTides.h"
+#include "GravityTruncation.h"
 
 /*%--------------------------------------------------------------------------
 %
@@ -56,7 +59,8 @@
  *
  * @param x Tiempo en segundos desde la época de referencia.
  * @param Y Vector de estado del satélite en el sistema ICRF/EME2000.
- * @return double* Aceleración (a=d^2r/dt^2) en el sistema ICRF/EME2000.
+ * @param dY Derivada del vector de estado (salida, 6).
+ * @param p Época y modelo de fuerzas de la propagación.
  *
  * @details
  * La función utiliza varias subrutinas y datos globales para calcular la aceleración:
@@ -65,8 +69,8 @@
  * - `PrecMatrix`, `NutMatrix`, `PoleMatrix`, `GHAMatrix`: Para calcular matrices de precesión, nutación y otros efectos.
  * - `Mjday_TDB`: Para convertir la fecha a tiempo dinámico baricéntrico.
  * - `JPL_Eph_DE430`: Para obtener posiciones planetarias del efeméride JPL DE430.
- * - `AccelHarmonic`: Para calcular la aceleración debida al campo gravitacional armónico de la Tierra.
- * - `AccelPointMass`: Para calcular las aceleraciones debidas a cuerpos puntuales (Sol, Luna, planetas).
+ * - `StandardForces`: Campo armónico, terceros cuerpos, resistencia atmosférica, presión de
+ *   radiación solar y corrección relativista (ver `ForceModel`), compuestos en tiempo de compilación.
  *
  * @note Esta función asume que los datos globales y funciones auxiliares están correctamente definidas y accesibles.
  *
@@ -76,90 +80,229 @@
  * @bug Asegúrese de que las matrices y vectores estén correctamente dimensionados y que no haya desbordamientos de memoria.
  * @warning Verificar la precisión de los parámetros de entrada para obtener resultados precisos.
  */
-double* Accel(double x, double* Y) {
+void Accel(double x, const double* Y, double* dY, const AccelParam& p) {
+    static const StandardForces forces;
+    Accel(x, Y, dY, p, forces);
+}
+
+/**
+ * @brief Aceleración con una composición dada del modelo de fuerzas.
+ *
+ * @param x Tiempo en segundos desde la época de referencia.
+ * @param Y Vector de estado del satélite en el sistema ICRF/EME2000.
+ * @param dY Derivada del vector de estado (salida, 6).
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @param forces Contribuyentes (`ForceSum` o `ForceRegistry`).
+ */
+void Accel(double x, const double* Y, double* dY, const AccelParam& p, const ForceModel& forces) {
+    STAT_COUNT(STAT_ACCEL);
+    ForceContext c;
+    AccelEpoch(x, p, c);
+    c.setState(Y);
+
+    double a[3] = {0.0, 0.0, 0.0};
+    forces.accumulate(c, a);
+
+    for (int i = 0; i < 3; i++) {
+        dY[i] = Y[i+3];
+        dY[i+3] = a[i];
+    }
+}
+
+static void TideBodies(double Mjd_UTC, const AccelParam& p, double* s_bf, double* m_bf);
+
+/**
+ * @brief Vector de ICRF al sistema ligado a la Tierra.
+ */
+static void BodyFixed(const Matrix& E, const double* r, double* r_bf) {
+    for (int i = 0; i < 3; i++) {
+        r_bf[i] = E(i+1,1)*r[0] + E(i+1,2)*r[1] + E(i+1,3)*r[2];
+    }
+}
+
+/**
+ * @brief Cantidades de la época comunes a todos los contribuyentes.
+ *
+ * @param x Tiempo en segundos desde la época de referencia.
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @param c Contexto (salida): épocas TT y UT1, matrices T y E, terceros cuerpos, Sol, Luna y
+ * bloque del campo gravitatorio corregido por mareas (exacto, o interpolado entre nodos separados `p.tide_step` segundos).
+ */
+void AccelEpoch(double x, const AccelParam& p, ForceContext& c) {
     double x_pole, y_pole, UT1_UTC, dpsi, LOD, deps, dx_pole, dy_pole, TAI_UTC, UT1_TAI, UTC_GPS, UT1_GPS, TT_UTC, GPS_UTC;
-    double* r_Mercury;
-    double *r_Venus;
-    double* r_Earth;
-    double* r_Mars;
-    double* r_Jupiter;
-    double* r_Saturn;
-    double* r_Uranus;
-    double* r_Neptune;
-    double* r_Pluto;
-    double* r_Moon;
-    double* r_Sun;
-
-    IERS(*global::eopdate, global::Mjd_UTC + x/86400, 'l', x_pole, y_pole, UT1_UTC, LOD, dpsi, deps, dx_pole, dy_pole, TAI_UTC);
+
+    c.p = &p;
+    STAT_TIMER_START(TIMER_IERS);
+    IERS(*global::eopdate, p.Mjd_UTC + x/86400, 'l', x_pole, y_pole, UT1_UTC, LOD, dpsi, deps, dx_pole, dy_pole, TAI_UTC);
     timediff(UT1_UTC, TAI_UTC, UT1_TAI, UTC_GPS, UT1_GPS, TT_UTC, GPS_UTC);
-    double Mjd_UT1 = global::Mjd_UTC + x/86400 + UT1_UTC/86400;
-    double Mjd_TT = global::Mjd_UTC + x/86400 + TT_UTC/86400;
+    c.Mjd_UT1 = p.Mjd_UTC + x/86400 + UT1_UTC/86400;
+    c.Mjd_TT = p.Mjd_UTC + x/86400 + TT_UTC/86400;
+    STAT_TIMER_STOP(TIMER_IERS);
 
-    Matrix P = PrecMatrix(MJD_J2000, Mjd_TT);
-    Matrix N = NutMatrix(Mjd_TT);
-    Matrix T = N * P;
-    Matrix E = PoleMatrix(x_pole, y_pole) * GHAMatrix(Mjd_UT1) * T;
+    STAT_TIMER_START(TIMER_FRAMES);
+    Matrix P = PrecMatrix(MJD_J2000, c.Mjd_TT);
+    Matrix N = NutMatrix(c.Mjd_TT);
+    c.T = N * P;
+    c.E = PoleMatrix(x_pole, y_pole) * GHAMatrix(c.Mjd_UT1) * c.T;
+    STAT_TIMER_STOP(TIMER_FRAMES);
 
-    double MJD_TDB = Mjday_TDB(Mjd_TT);
-    JPL_Eph_DE430(MJD_TDB, r_Mercury, r_Venus, r_Earth, r_Mars, r_Jupiter, r_Saturn, r_Uranus, r_Neptune, r_Pluto, r_Moon, r_Sun);
+    STAT_TIMER_START(TIMER_JPL);
+    bool sun = p.density != nullptr || p.sRad || p.tides;
+    c.bodies = ThirdBodies(c.Mjd_TT, p, sun ? c.r_Sun : nullptr, p.tides ? c.r_Moon : nullptr);
+    STAT_TIMER_STOP(TIMER_JPL);
 
-    // Acceleration due to harmonic gravity field
-    int s;
-    double* a = AccelHarmonic(extractSubarray(Y, 0, 2, s), E, global::n, global::m);
-    double* aux;
-
-    // Luni-solar perturbations
-    if (global::sun) {
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Sun, GM_Sun);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
+    //% Solid Earth tides: patched low-degree block of the gravity field, exact or
+    //% interpolated between nodes p.tide_step seconds apart
+    if (p.tides) {
+        if (p.tide_step > 0.0) {
+            static thread_local TideCache tides;
+            c.tide = tides.get(p.Mjd_UTC + x/86400, p.tide_step,
+                               [&p](double Mjd_UTC, double* s_bf, double* m_bf) { TideBodies(Mjd_UTC, p, s_bf, m_bf); });
+        } else {
+            double s_bf[3], m_bf[3], dC[5][5], dS[5][5];
+            BodyFixed(c.E, c.r_Sun, s_bf);
+            BodyFixed(c.E, c.r_Moon, m_bf);
+            SolidTides(s_bf, m_bf, dC, dS);
+            c.tide.set(dC, dS);
         }
     }
+}
 
-    if (global::moon) {
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Moon);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
+/**
+ * @brief Posiciones del Sol y la Luna en el sistema ligado a la Tierra en una época.
+ *
+ * @param Mjd_UTC Época (UTC, Modified Julian Date).
+ * @param p Modelo de fuerzas (sólo se usa para la época de referencia de `AccelEpoch`).
+ * @param s_bf Sol en el sistema ligado a la Tierra (salida, 3).
+ * @param m_bf Luna en el sistema ligado a la Tierra (salida, 3).
+ */
+static void TideBodies(double Mjd_UTC, const AccelParam& p, double* s_bf, double* m_bf) {
+    AccelParam q = p;
+    q.Mjd_UTC = Mjd_UTC;
+    q.sun = 0;
+    q.moon = 0;
+    q.planets = 0;
+    q.density = nullptr;
+    q.sRad = 0;
+    q.tides = 0;
+    ForceContext c;
+    AccelEpoch(0.0, q, c);
+    double r_Sun[3], r_Moon[3];
+    ThirdBodies(c.Mjd_TT, q, r_Sun, r_Moon);
+    BodyFixed(c.E, r_Sun, s_bf);
+    BodyFixed(c.E, r_Moon, m_bf);
+}
+
+/**
+ * @brief Masas puntuales perturbadoras (Sol, Luna y planetas) activas en el modelo de fuerzas.
+ *
+ * @param Mjd_TT Época (Terrestrial Time, Modified Julian Date).
+ * @param p Modelo de fuerzas (p.sun, p.moon, p.planets).
+ * @param r_Sun Posición geocéntrica del Sol (salida opcional, 3); si no es nulo se leen las
+ * efemérides aunque no haya ningún cuerpo activo.
+ * @param r_Moon Posición geocéntrica de la Luna (salida opcional, 3), como r_Sun.
+ * @return PointMasses Posiciones geocéntricas de JPL DE430 y sus términos indirectos.
+ */
+PointMasses ThirdBodies(double Mjd_TT, const AccelParam& p, double* r_Sun_out, double* r_Moon_out) {
+    double rb[11][3];
+    double *r_Mercury = rb[0], *r_Venus = rb[1], *r_Earth = rb[2], *r_Mars = rb[3], *r_Jupiter = rb[4],
+           *r_Saturn = rb[5], *r_Uranus = rb[6], *r_Neptune = rb[7], *r_Pluto = rb[8], *r_Moon = rb[9], *r_Sun = rb[10];
+    PointMasses bodies;
+    if (!p.sun && !p.moon && !p.planets && r_Sun_out == nullptr && r_Moon_out == nullptr) {
+        return bodies;
     }
 
-    // Planetary perturbations
-    if (global::planets) {
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Mars);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Mercury);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Venus);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Jupiter);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Saturn);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Uranus);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
-        }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Neptune);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
+    double MJD_TDB = Mjday_TDB(Mjd_TT);
+    JPL_Eph_DE430(MJD_TDB, r_Mercury, r_Venus, r_Earth, r_Mars, r_Jupiter, r_Saturn, r_Uranus, r_Neptune, r_Pluto, r_Moon, r_Sun);
+    for (int i = 0; i < 3; i++) {
+        if (r_Sun_out != nullptr) {
+            r_Sun_out[i] = r_Sun[i];
         }
-        aux = AccelPointMass(extractSubarray(Y, 0, 2, s), r_Moon, GM_Pluto);
-        for (int i = 0; i < 3; i++) {
-            a[i] = a[i] + aux[i];
+        if (r_Moon_out != nullptr) {
+            r_Moon_out[i] = r_Moon[i];
         }
     }
-    int f;
-    double* dY = concatenateVectors(extractSubarray(Y, 3, 5, f), a, 3, 3);
 
+    if (p.sun) {
+        bodies.add(r_Sun, GM_Sun);
+    }
+    if (p.moon) {
+        bodies.add(r_Moon, GM_Moon);
+    }
+    if (p.planets) {
+        bodies.add(r_Mars, GM_Mars);
+        bodies.add(r_Mercury, GM_Mercury);
+        bodies.add(r_Venus, GM_Venus);
+        bodies.add(r_Jupiter, GM_Jupiter);
+        bodies.add(r_Saturn, GM_Saturn);
+        bodies.add(r_Uranus, GM_Uranus);
+        bodies.add(r_Neptune, GM_Neptune);
+        bodies.add(r_Pluto, GM_Pluto);
+    }
+    return bodies;
+}
+
+/**
+ * @brief Parámetros de la propagación tomados de las variables globales.
+ *
+ * @return AccelParam Época (global::Mjd_UTC, global::Mjd_TT) y modelo de fuerzas actuales.
+ */
+AccelParam GlobalAccelParam() {
+    AccelParam p;
+    p.Mjd_UTC = global::Mjd_UTC;
+    p.Mjd_TT = global::Mjd_TT;
+    p.n = global::n;
+    p.m = global::m;
+    p.sun = global::sun;
+    p.moon = global::moon;
+    p.planets = global::planets;
+    p.relativity = global::relativity;
+    p.mixed = 0;
+    p.trunc = nullptr;
+    p.grid = nullptr;
+    p.density = nullptr;
+    p.mass = 1.0;
+    p.area_drag = 0.0;
+    p.CD = 2.2;
+    p.sRad = 0;
+    p.area_solar = 0.0;
+    p.CR = 1.3;
+    p.shadow = SHADOW_CONICAL;
+    p.shadow_width = 1.0;
+    p.tides = 0;
+    p.tide_step = 0.0;
+    return p;
+}
+
+/**
+ * @brief Grado y orden del campo gravitatorio para una distancia.
+ *
+ * Con `p.trunc` nulo son los fijos p.n, p.m; si no, el grado se reduce con la distancia
+ * según el error admisible de `GravityTruncation` (y el orden no pasa del grado).
+ *
+ * @param p Modelo de fuerzas.
+ * @param d Distancia al centro de la Tierra [m].
+ * @param n Grado (salida).
+ * @param m Orden (salida).
+ */
+void GravityDegree(const AccelParam& p, double d, int& n, int& m) {
+    n = p.n;
+    m = p.m;
+    if (p.trunc != nullptr) {
+        n = p.trunc->degree(d, p.n);
+        m = m < n ? m : n;
+    }
+}
+
+/**
+ * @brief Aceleración con la época y el modelo de fuerzas de las variables globales.
+ *
+ * @param x Tiempo en segundos desde la época de referencia.
+ * @param Y Vector de estado del satélite en el sistema ICRF/EME2000.
+ * @return double* Derivada del vector de estado (memoria reservada con new[]).
+ */
+double* Accel(double x, double* Y) {
+    auto* dY = new double[6];
+    Accel(x, Y, dY, GlobalAccelParam());
     return dY;
 }
\ No newline at end of file
@@ -0,0 +1,340 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include "AccelBatch.h"
+#include "GravityGrid.h"
+#include "ForceModel.h"
+#include "SolidTides.h"
+#include "global.h"
+#include "RKInteg.h"
+
+/*%--------------------------------------------------------------------------
+%
+% AccelBatch: Acceleration of N satellites at a common epoch
+%
+% Same force model as Accel, but the epoch dependent quantities (Earth
+% orientation, transformation matrix, JPL ephemerides) are evaluated once
+% for the whole batch. The harmonic gravity field is evaluated for blocks
+% of LANES states in structure-of-arrays layout, so that the Legendre
+% recursions and the harmonic sums are inner loops over the states of the
+% block, which the compiler can map to SIMD lanes. The mixed-precision
+% kernel runs the same recursions in float above degree 4, with blocks of
+% 16 states.
+%
+% States are stored one after another: Y = [y_1; y_2; ... y_N], 6 each.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file AccelBatch.cpp
+ * @brief Aceleración y propagación conjunta de muchos estados con el mismo modelo de fuerzas.
+ */
+
+static const int LANES = 8;     // States per block of the harmonic kernel (double)
+static const int LANES_F = 16;  // States per block of the float kernel (same vector width)
+static const int N_DOUBLE = 4;  // Degrees summed in double by the mixed-precision kernel
+
+/**
+ * @brief Núcleo de la suma armónica para bloques de L estados, con aritmética T.
+ *
+ * Las funciones de Legendre, cos(m*lon), sin(m*lon) y las sumas de cada grado se calculan en
+ * T; la geometría, los factores (r_ref/d)^n y la acumulación de los grados, en double.
+ *
+ * @param n_lo Primer grado sumado (los anteriores solo intervienen en las recursiones).
+ * @param add Si es cierto, suma la aceleración a `a` en lugar de escribirla.
+ */
+template <class T, int L>
+static void HarmonicKernel(int N, const double* r, Matrix& E, int n_lo, int n_max, int m_max, double* a,
+                           const GravityPatch* patch, bool add){
+
+    const double r_ref = 6378.1363e3;   //% Earth's radius [m]; GGM03S
+    const double gm    = 398600.4415e9; //% [m^3/s^2]; GGM03S
+    const int nm = (n_max+1)*(m_max+1);
+    Matrix& Cnm = *global::Cnm;
+    Matrix& Snm = *global::Snm;
+
+    double e[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            e[i][j] = E(i+1,j+1);
+        }
+    }
+
+    std::vector<T> pnm(nm*L), dpnm(nm*L), cml((m_max+1)*L), sml((m_max+1)*L);
+    #define P(i,j,l) pnm[((i)*(m_max+1)+(j))*L+(l)]
+    #define DP(i,j,l) dpnm[((i)*(m_max+1)+(j))*L+(l)]
+
+    for (int k0 = 0; k0 < N; k0 += L) {
+        double x[L], y[L], z[L], d[L], rxy[L];
+        T cphi[L], sphi[L];
+
+        //% Body-fixed position; the last block is padded with its last state
+        for (int l = 0; l < L; l++) {
+            int k = k0+l < N ? k0+l : N-1;
+            const double* rk = &r[3*k];
+            x[l] = e[0][0]*rk[0] + e[0][1]*rk[1] + e[0][2]*rk[2];
+            y[l] = e[1][0]*rk[0] + e[1][1]*rk[1] + e[1][2]*rk[2];
+            z[l] = e[2][0]*rk[0] + e[2][1]*rk[1] + e[2][2]*rk[2];
+        }
+        for (int l = 0; l < L; l++) {
+            rxy[l] = sqrt(x[l]*x[l] + y[l]*y[l]);
+            d[l] = sqrt(rxy[l]*rxy[l] + z[l]*z[l]);
+            sphi[l] = (T) (z[l]/d[l]);
+            cphi[l] = (T) (rxy[l]/d[l]);
+            cml[l] = 1.0;
+            sml[l] = 0.0;
+        }
+        //% cos(m*lon), sin(m*lon) by the angle addition recurrence
+        for (int m = 1; m <= m_max; m++) {
+            for (int l = 0; l < L; l++) {
+                T cl = (T) (x[l]/rxy[l]), sl = (T) (y[l]/rxy[l]);
+                cml[m*L+l] = cml[(m-1)*L+l]*cl - sml[(m-1)*L+l]*sl;
+                sml[m*L+l] = sml[(m-1)*L+l]*cl + cml[(m-1)*L+l]*sl;
+            }
+        }
+
+        //% Fully normalized Legendre functions and derivatives (as in Legendre)
+        for (int l = 0; l < L; l++) {
+            P(0,0,l) = 1.0;
+            DP(0,0,l) = 0.0;
+        }
+        if (n_max >= 1 && m_max >= 1) {
+            for (int l = 0; l < L; l++) {
+                P(1,1,l) = (T) sqrt(3.0)*cphi[l];
+                DP(1,1,l) = -(T) sqrt(3.0)*sphi[l];
+            }
+        }
+        for (int i = 2; i <= m_max; i++) {
+            T c = (T) sqrt((2.0*i+1.0)/(2.0*i));
+            for (int l = 0; l < L; l++) {
+                P(i,i,l) = c*cphi[l]*P(i-1,i-1,l);
+                DP(i,i,l) = c*(cphi[l]*DP(i-1,i-1,l) - sphi[l]*P(i-1,i-1,l));
+            }
+        }
+        for (int i = 1; i <= n_max && i-1 <= m_max; i++) {
+            T c = (T) sqrt(2.0*i+1.0);
+            for (int l = 0; l < L; l++) {
+                P(i,i-1,l) = c*sphi[l]*P(i-1,i-1,l);
+                DP(i,i-1,l) = c*(cphi[l]*P(i-1,i-1,l) + sphi[l]*DP(i-1,i-1,l));
+            }
+        }
+        for (int j = 0; j <= m_max; j++) {
+            for (int i = j+2; i <= n_max; i++) {
+                T c0 = (T) sqrt((2.0*i+1.0)/((i-j)*(i+j)));
+                T c1 = (T) sqrt(2.0*i-1.0);
+                T c2 = (T) sqrt(((i+j-1.0)*(i-j-1.0))/(2.0*i-3.0));
+                for (int l = 0; l < L; l++) {
+                    P(i,j,l) = c0*(c1*sphi[l]*P(i-1,j,l) - c2*P(i-2,j,l));
+                    DP(i,j,l) = c0*(c1*sphi[l]*DP(i-1,j,l) + c1*cphi[l]*P(i-1,j,l) - c2*DP(i-2,j,l));
+                }
+            }
+        }
+
+        //% Harmonic sums; every degree is added to the double accumulators
+        double dUdr[L], dUdlat[L], dUdlon[L], rn[L];
+        for (int l = 0; l < L; l++) {
+            dUdr[l] = 0.0;
+            dUdlat[l] = 0.0;
+            dUdlon[l] = 0.0;
+            rn[l] = 1.0;
+        }
+        for (int n = 0; n <= n_max; n++) {
+            if (n >= n_lo) {
+                T q1[L], q2[L], q3[L];
+                for (int l = 0; l < L; l++) {
+                    q1[l] = 0.0;
+                    q2[l] = 0.0;
+                    q3[l] = 0.0;
+                }
+                bool patched = patch != nullptr && n <= patch->n;
+                for (int m = 0; m <= m_max && m <= n; m++) {
+                    T C = (T) (patched ? patch->C[n][m] : Cnm(n+1,m+1));
+                    T S = (T) (patched ? patch->S[n][m] : Snm(n+1,m+1));
+                    for (int l = 0; l < L; l++) {
+                        T cs = C*cml[m*L+l] + S*sml[m*L+l];
+                        q1[l] += P(n,m,l)*cs;
+                        q2[l] += DP(n,m,l)*cs;
+                        q3[l] += m*P(n,m,l)*(S*cml[m*L+l] - C*sml[m*L+l]);
+                    }
+                }
+                for (int l = 0; l < L; l++) {
+                    double b = gm/d[l]*rn[l];
+                    dUdr[l] += -b/d[l]*(n+1)*q1[l];
+                    dUdlat[l] += b*q2[l];
+                    dUdlon[l] += b*q3[l];
+                }
+            }
+            for (int l = 0; l < L; l++) {
+                rn[l] *= r_ref/d[l];
+            }
+        }
+
+        //% Body-fixed and inertial acceleration
+        for (int l = 0; l < L && k0+l < N; l++) {
+            double r2xy = rxy[l]*rxy[l];
+            double t1 = dUdr[l]/d[l] - z[l]/(d[l]*d[l]*rxy[l])*dUdlat[l];
+            double ax = t1*x[l] - dUdlon[l]/r2xy*y[l];
+            double ay = t1*y[l] + dUdlon[l]/r2xy*x[l];
+            double az = dUdr[l]/d[l]*z[l] + rxy[l]/(d[l]*d[l])*dUdlat[l];
+            double* ak = &a[3*(k0+l)];
+            for (int i = 0; i < 3; i++) {
+                double ai = e[0][i]*ax + e[1][i]*ay + e[2][i]*az;
+                ak[i] = add ? ak[i] + ai : ai;
+            }
+        }
+    }
+    #undef P
+    #undef DP
+}
+
+/**
+ * @brief Aceleración del campo gravitatorio armónico para N posiciones.
+ *
+ * Equivale a llamar a `AccelHarmonic` para cada posición.
+ *
+ * @param N Número de posiciones.
+ * @param r Posiciones en el sistema inercial (N x 3, por filas).
+ * @param E Matriz de transformación al sistema ligado a la Tierra.
+ * @param n_max Grado máximo.
+ * @param m_max Orden máximo (m_max <= n_max).
+ * @param a Aceleraciones en el sistema inercial (salida, N x 3).
+ * @param patch Bloque de grado bajo que sustituye a las tablas globales hasta su grado (nulo: ninguno).
+ * @throws std::invalid_argument Si n_max supera el grado cargado con `global::GGM03S`.
+ */
+void AccelHarmonicBatch(int N, const double* r, Matrix& E, int n_max, int m_max, double* a,
+                        const GravityPatch* patch){
+    if (n_max >= global::Cnm->getRows()) {
+        throw std::invalid_argument("AccelHarmonicBatch: degree above the loaded gravity field");
+    }
+    if (N == 1) {
+        HarmonicKernel<double, 1>(N, r, E, 0, n_max, m_max, a, patch, false);
+    } else {
+        HarmonicKernel<double, LANES>(N, r, E, 0, n_max, m_max, a, patch, false);
+    }
+}
+
+/**
+ * @brief Aceleración del campo gravitatorio armónico para N posiciones en precisión mixta.
+ *
+ * Los grados 0 a 4 (término central, J2, mareas) se suman en double; el resto, con las
+ * recursiones de Legendre en float en bloques de 16 estados (el doble que en double con el
+ * mismo ancho de vector), y la suma de cada grado se acumula en double. Pensado para
+ * propagaciones de cribado; `HarmonicPrecision` mide el error frente a `AccelHarmonicBatch`.
+ *
+ * @param N Número de posiciones.
+ * @param r Posiciones en el sistema inercial (N x 3, por filas).
+ * @param E Matriz de transformación al sistema ligado a la Tierra.
+ * @param n_max Grado máximo.
+ * @param m_max Orden máximo (m_max <= n_max).
+ * @param a Aceleraciones en el sistema inercial (salida, N x 3).
+ * @param patch Bloque de grado bajo que sustituye a las tablas globales hasta su grado (nulo: ninguno).
+ * @throws std::invalid_argument Si n_max supera el grado cargado con `global::GGM03S`.
+ */
+void AccelHarmonicMixed(int N, const double* r, Matrix& E, int n_max, int m_max, double* a,
+                        const GravityPatch* patch){
+    if (n_max >= global::Cnm->getRows()) {
+        throw std::invalid_argument("AccelHarmonicMixed: degree above the loaded gravity field");
+    }
+    int n_lo = n_max < N_DOUBLE ? n_max : N_DOUBLE;
+    int m_lo = m_max < n_lo ? m_max : n_lo;
+    if (N == 1) {
+        HarmonicKernel<double, 1>(N, r, E, 0, n_lo, m_lo, a, patch, false);
+    } else {
+        HarmonicKernel<double, LANES>(N, r, E, 0, n_lo, m_lo, a, patch, false);
+    }
+    if (n_max > n_lo) {
+        if (N == 1) {
+            HarmonicKernel<float, 1>(N, r, E, n_lo+1, n_max, m_max, a, patch, true);
+        } else {
+            HarmonicKernel<float, LANES_F>(N, r, E, n_lo+1, n_max, m_max, a, patch, true);
+        }
+    }
+}
+
+/**
+ * @brief Derivada del estado de N satélites en una misma época.
+ *
+ * @param x Tiempo en segundos desde la época de referencia.
+ * @param N Número de satélites.
+ * @param Y Estados en el sistema ICRF/EME2000 (6N).
+ * @param dY Derivadas de los estados (salida, 6N).
+ * @param p Época y modelo de fuerzas de la propagación.
+ */
+void AccelBatch(double x, int N, const double* Y, double* dY, const AccelParam& p){
+    static const ForceSum<ThirdBodyForce, DragForce, SolradForce, RelativityForce> perturbations;
+
+    //% Epoch dependent quantities, once for the whole batch
+    ForceContext c;
+    AccelEpoch(x, p, c);
+
+    std::vector<double> r(3*N), a(3*N);
+    for (int k = 0; k < N; k++) {
+        for (int i = 0; i < 3; i++) {
+            r[3*k+i] = Y[6*k+i];
+        }
+    }
+
+    const GravityPatch* patch = p.tides ? &c.tide : nullptr;
+    if (p.grid != nullptr) {
+        //% Tabulated field; the states outside its shell use the direct sum
+        for (int k = 0; k < N; k++) {
+            if (!p.grid->accel(&r[3*k], c.E, &a[3*k])) {
+                AccelHarmonicBatch(1, &r[3*k], c.E, p.n, p.m, &a[3*k], patch);
+            } else if (patch != nullptr) {
+                AccelPatch(&r[3*k], c.E, *patch, &a[3*k]);
+            }
+        }
+    } else {
+        //% One degree for the whole batch, set by the lowest state
+        double dmin = 0.0;
+        for (int k = 0; k < N; k++) {
+            double d = sqrt(r[3*k]*r[3*k] + r[3*k+1]*r[3*k+1] + r[3*k+2]*r[3*k+2]);
+            dmin = (k == 0 || d < dmin) ? d : dmin;
+        }
+        int n, m;
+        GravityDegree(p, dmin, n, m);
+        if (p.mixed) {
+            AccelHarmonicMixed(N, r.data(), c.E, n, m, a.data(), patch);
+        } else {
+            AccelHarmonicBatch(N, r.data(), c.E, n, m, a.data(), patch);
+        }
+    }
+
+    //% Remaining contributors, state by state
+    for (int k = 0; k < N; k++) {
+        c.setState(&Y[6*k]);
+        perturbations.accumulate(c, &a[3*k]);
+    }
+
+    for (int k = 0; k < N; k++) {
+        for (int i = 0; i < 3; i++) {
+            dY[6*k+i] = Y[6*k+i+3];
+            dY[6*k+i+3] = a[3*k+i];
+        }
+    }
+}
+
+/**
+ * @brief Propaga N estados a la vez con un único paso de integración.
+ *
+ * Los estados avanzan juntos con `RKInteg`; el error de cada paso es el máximo de los
+ * errores de los estados, de modo que todos cumplen la tolerancia pedida.
+ *
+ * @param N Número de estados.
+ * @param t Instante inicial [s].
+ * @param tout Instante final [s].
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @param Y Estados (6N) en t (entrada) y en tout (salida).
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @return double* Puntero a Y.
+ */
+double* PropagateBatch(int N, double t, double tout, double relerr, double abserr, double* Y, const AccelParam& p){
+    auto f = [N, &p](double x, const double* y, double* dy) {
+        AccelBatch(x, N, y, dy, p);
+    };
+    return RKInteg(f,t,tout,relerr,abserr,6*N,Y,6);
+}
@@ -0,0 +1,71 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "AccelDrag.h"
+#include "SAT_Const.h"
+
+/*%--------------------------------------------------------------------------
+%
+% AccelDrag: Computes the acceleration due to the atmospheric drag
+%
+%   a = -1/2 CD A/m rho |v_rel| v_rel,  v_rel = v - omega x r
+%
+% The relative velocity and the density are evaluated in the true of date
+% system, where the atmosphere rotates with the Earth about the z axis.
+%
+% Reference:
+%   O. Montenbruck, E. Gill, "Satellite Orbits", Springer, 2000;
+%   Section 3.5.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file AccelDrag.cpp
+ * @brief Aceleración debida a la resistencia atmosférica.
+ */
+
+/**
+ * @brief Suma la aceleración de la resistencia atmosférica.
+ *
+ * @param model Modelo de densidad atmosférica.
+ * @param Mjd_TT Época (Terrestrial Time, Modified Julian Date).
+ * @param r Posición del satélite en el sistema ICRF/EME2000 [m].
+ * @param v Velocidad del satélite en el sistema ICRF/EME2000 [m/s].
+ * @param r_Sun Posición geocéntrica del Sol en el sistema ICRF/EME2000 [m].
+ * @param T Matriz de transformación del ICRF al sistema verdadero de la fecha (N*P).
+ * @param Area Sección transversal [m^2].
+ * @param mass Masa del satélite [kg].
+ * @param CD Coeficiente de resistencia.
+ * @param a Aceleración en el sistema ICRF/EME2000 (entrada y salida: se suma el término).
+ */
+void AccelDrag(const DensityModel& model, double Mjd_TT, const double* r, const double* v, const double* r_Sun,
+               Matrix& T, double Area, double mass, double CD, double* a){
+    double t[3][3], r_tod[3], v_rel[3], s_tod[3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            t[i][j] = T(i+1,j+1);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        r_tod[i] = t[i][0]*r[0] + t[i][1]*r[1] + t[i][2]*r[2];
+        v_rel[i] = t[i][0]*v[0] + t[i][1]*v[1] + t[i][2]*v[2];
+        s_tod[i] = t[i][0]*r_Sun[0] + t[i][1]*r_Sun[1] + t[i][2]*r_Sun[2];
+    }
+
+    double dens = model.density(Mjd_TT, r_tod, s_tod);
+    if (dens == 0.0) {
+        return;
+    }
+
+    //% Velocity relative to the Earth's atmosphere
+    v_rel[0] += omega_Earth*r_tod[1];
+    v_rel[1] -= omega_Earth*r_tod[0];
+    double v_abs = sqrt(v_rel[0]*v_rel[0] + v_rel[1]*v_rel[1] + v_rel[2]*v_rel[2]);
+    double c = -0.5*CD*(Area/mass)*dens*v_abs;
+
+    //% Acceleration back to the ICRF (T' * a_tod)
+    for (int i = 0; i < 3; i++) {
+        a[i] += c*(t[0][i]*v_rel[0] + t[1][i]*v_rel[1] + t[2][i]*v_rel[2]);
+    }
+}
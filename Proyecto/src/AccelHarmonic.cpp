@@ -2,10 +2,10 @@
 // Created by Adam on 24/05/2024.
 //
 #include "Matrix.h"
-#include "norm.h"
-#include "Legendre.h"
 #include "global.h"
+#include "SolidTides.h"
 #include <cmath>
+#include <stdexcept>
 /*%--------------------------------------------------------------------------
 %
 % AccelHarmonic.m
@@ -31,6 +31,8 @@
  * @brief Función para calcular la aceleración debido al campo gravitacional armónico de un cuerpo central.
  */
 
+static const int NMAX_FUSED = 360;     // Highest degree of the fused kernel (stack rows)
+
 /**
  * @brief Calcula la aceleración debida al campo gravitacional armónico de un cuerpo central.
  *
@@ -41,84 +43,132 @@
  * @param E Matriz de transformación al sistema centrado en el cuerpo central.
  * @param n_max Máximo grado del campo armónico.
  * @param m_max Máximo orden del campo armónico (m_max <= n_max; m_max = 0 solo para armónicos zonales).
- * @return double* Aceleración en el sistema inercial.
+ * @param a Aceleración en el sistema inercial (salida, 3).
+ * @param patch Bloque de grado bajo que sustituye a `global::Cnm`/`global::Snm` hasta su grado
+ * (mareas; nulo: solo las tablas globales).
+ * @throws std::invalid_argument Si n_max supera el grado cargado con `global::GGM03S` o 360.
  *
  * @details
- * La función utiliza las siguientes subrutinas y constantes globales:
- * - `norm`: Para calcular la norma del vector.
- * - `Legendre`: Para calcular los polinomios de Legendre asociados.
- *
- * @note Esta función asume que las matrices y vectores están correctamente dimensionados y que no hay desbordamientos de memoria.
- *
- * @version 1.0
- * @date 2024-05-24
- *
- * @bug Asegúrese de que las matrices y vectores estén correctamente dimensionados y que no haya desbordamientos de memoria.
- * @warning Verificar la precisión de los parámetros de entrada para obtener resultados precisos.
+ * Núcleo fusionado: las funciones de Legendre normalizadas (mismas recurrencias que `Legendre`)
+ * de cada grado se generan a partir de las de los dos grados anteriores, que se guardan en
+ * filas rotatorias en la pila, y se suman en el acto con la fila de Cnm/Snm de ese grado.
+ * cos(m*lon), sin(m*lon) se obtienen por recurrencia a partir de x/rxy, y/rxy, y (r_ref/d)^n
+ * como potencia acumulada, sin asin, atan2, pow ni matrices intermedias: la función no reserva
+ * memoria y solo recorre los coeficientes.
  */
-double* AccelHarmonic(double* r,Matrix E,int n_max,int m_max){
-
-
-
-double r_ref = 6378.1363e3;   //% Earth's radius [m]; GGM03S
-double gm    = 398600.4415e9; //% [m^3/s^2]; GGM03S
+void AccelHarmonic(const double* r, const Matrix& E, int n_max, int m_max, double* a, const GravityPatch* patch){
 
-//% Body-fixed position
-double* r_bf =E.multiply(E,r,3);
-
-//% Auxiliary quantities
-double d = norm(r_bf,3);                    // % distance
-double latgc = asin(r_bf[2]/d);
-double lon = atan2(r_bf[1],r_bf[0]);
+    if (n_max >= global::Cnm->getRows() || n_max > NMAX_FUSED) {
+        throw std::invalid_argument("AccelHarmonic: degree above the loaded gravity field");
+    }
 
+    const double r_ref = 6378.1363e3;   //% Earth's radius [m]; GGM03S
+    const double gm    = 398600.4415e9; //% [m^3/s^2]; GGM03S
+    Matrix& Cnm = *global::Cnm;
+    Matrix& Snm = *global::Snm;
 
-    Matrix pnm(n_max+1,m_max+1);
-    Matrix dpnm(n_max+1,m_max+1);
-    Legendre(n_max, m_max, latgc, pnm, dpnm);
+    //% Body-fixed position
+    double r_bf[3];
+    for (int i = 0; i < 3; i++) {
+        r_bf[i] = E(i+1,1)*r[0] + E(i+1,2)*r[1] + E(i+1,3)*r[2];
+    }
 
-double dUdr = 0;
-double dUdlatgc = 0;
-double dUdlon = 0;
-double q3 = 0;double q2 = q3;double q1 = q2;
+    //% Auxiliary quantities
+    double rxy = sqrt(r_bf[0]*r_bf[0] + r_bf[1]*r_bf[1]);
+    double d = sqrt(rxy*rxy + r_bf[2]*r_bf[2]);
+    double sphi = r_bf[2]/d, cphi = rxy/d;
+    double cl = r_bf[0]/rxy, sl = r_bf[1]/rxy;
+
+    //% cos(m*lon), sin(m*lon) by the angle addition recurrence
+    double cml[NMAX_FUSED+1], sml[NMAX_FUSED+1];
+    cml[0] = 1.0;
+    sml[0] = 0.0;
+    for (int m = 1; m <= m_max; m++) {
+        cml[m] = cml[m-1]*cl - sml[m-1]*sl;
+        sml[m] = sml[m-1]*cl + cml[m-1]*sl;
+    }
 
+    //% Rolling rows n-2, n-1, n of the Legendre functions and derivatives
+    double buf[6][NMAX_FUSED+1];
+    double *P2 = buf[0], *P1 = buf[1], *P0 = buf[2];
+    double *D2 = buf[3], *D1 = buf[4], *D0 = buf[5];
+
+    double dUdr = 0.0, dUdlatgc = 0.0, dUdlon = 0.0;
+    double rn = gm/d;                   // gm/d*(r_ref/d)^n
+    for (int n = 0; n <= n_max; n++) {
+        int mn = n < m_max ? n : m_max;
+
+        //% Legendre functions of degree n from degrees n-1 and n-2
+        if (n == 0) {
+            P0[0] = 1.0;
+            D0[0] = 0.0;
+        } else {
+            for (int j = 0; j <= mn && j <= n-2; j++) {
+                double c0 = sqrt((2.0*n+1.0)/((n-j)*(n+j)));
+                double c1 = sqrt(2.0*n-1.0);
+                double c2 = sqrt(((n+j-1.0)*(n-j-1.0))/(2.0*n-3.0));
+                P0[j] = c0*(c1*sphi*P1[j] - c2*P2[j]);
+                D0[j] = c0*(c1*sphi*D1[j] + c1*cphi*P1[j] - c2*D2[j]);
+            }
+            if (n-1 <= mn) {
+                double c = sqrt(2.0*n+1.0);
+                P0[n-1] = c*sphi*P1[n-1];
+                D0[n-1] = c*(cphi*P1[n-1] + sphi*D1[n-1]);
+            }
+            if (n <= mn) {
+                double c = n == 1 ? sqrt(3.0) : sqrt((2.0*n+1.0)/(2.0*n));
+                P0[n] = c*cphi*P1[n-1];
+                D0[n] = n == 1 ? -c*sphi : c*(cphi*D1[n-1] - sphi*P1[n-1]);
+            }
+        }
+
+        //% Harmonic sums of degree n over the coefficient row
+        bool patched = patch != nullptr && n <= patch->n;
+        const double* Cn = patched ? patch->C[n] : &Cnm(n+1,1);
+        const double* Sn = patched ? patch->S[n] : &Snm(n+1,1);
+        double q1 = 0.0, q2 = 0.0, q3 = 0.0;
+        for (int m = 0; m <= mn; m++) {
+            double cs = Cn[m]*cml[m] + Sn[m]*sml[m];
+            q1 += P0[m]*cs;
+            q2 += D0[m]*cs;
+            q3 += m*P0[m]*(Sn[m]*cml[m] - Cn[m]*sml[m]);
+        }
+        dUdr     += -rn/d*(n+1)*q1;
+        dUdlatgc += rn*q2;
+        dUdlon   += rn*q3;
+        rn *= r_ref/d;
+
+        double* t = P2; P2 = P1; P1 = P0; P0 = t;
+        t = D2; D2 = D1; D1 = D0; D0 = t;
+    }
 
-    double b1,b2,b3;
-for(int n=0;n<=n_max;n++){
-    b1 = (-gm/pow(d,2))*pow((r_ref/d),n)*(n+1);
-    b2 =  (gm/d)*pow((r_ref/d),n);
-    b3 =  (gm/d)*pow((r_ref/d),n);
-    for (int m=0;m<=m_max;m++){
-        q1 = q1 + pnm(n+1,m+1)*((*global::Cnm)(n+1,m+1)*cos(m*lon)+(*global::Snm)(n+1,m+1)*sin(m*lon));
-        q2 = q2 + dpnm(n+1,m+1)*((*global::Cnm)(n+1,m+1)*cos(m*lon)+(*global::Snm)(n+1,m+1)*sin(m*lon));
-        q3 = q3 + m*pnm(n+1,m+1)*((*global::Snm)(n+1,m+1)*cos(m*lon)-(*global::Cnm)(n+1,m+1)*sin(m*lon));
+    //% Body-fixed acceleration
+    double r2xy = rxy*rxy;
+    double t1 = dUdr/d - r_bf[2]/(d*d*rxy)*dUdlatgc;
+    double a_bf[3];
+    a_bf[0] = t1*r_bf[0] - dUdlon/r2xy*r_bf[1];
+    a_bf[1] = t1*r_bf[1] + dUdlon/r2xy*r_bf[0];
+    a_bf[2] = dUdr/d*r_bf[2] + rxy/(d*d)*dUdlatgc;
+
+    //% Inertial acceleration
+    for (int i = 0; i < 3; i++) {
+        a[i] = E(1,i+1)*a_bf[0] + E(2,i+1)*a_bf[1] + E(3,i+1)*a_bf[2];
     }
-    dUdr     = dUdr     + q1*b1;
-    dUdlatgc = dUdlatgc + q2*b2;
-    dUdlon   = dUdlon   + q3*b3;
-    q3 = 0; q2 = q3; q1 = q2;
 }
 
-
-
-
-
-
-
-//% Body-fixed acceleration
-double r2xy = pow(r_bf[0],2)+pow(r_bf[1],2);
-
-double ax = (1/d*dUdr-r_bf[2]/(pow(d,2)*sqrt(r2xy))*dUdlatgc)*r_bf[0]-(1/r2xy*dUdlon)*r_bf[1];
-double ay = (1/d*dUdr-r_bf[2]/(pow(d,2)*sqrt(r2xy))*dUdlatgc)*r_bf[1]+(1/r2xy*dUdlon)*r_bf[0];
-double az =  1/d*dUdr*r_bf[2]+sqrt(r2xy)/pow(d,2)*dUdlatgc;
-
-    auto* a_bf = new double[3];
-    a_bf[0] = ax;
-    a_bf[1] = ay;
-    a_bf[2] = az;
-
-//% Inertial acceleration
- double* a = E.multiply(E,a_bf,3);
-
- return a;
-
+/**
+ * @brief Aceleración del campo gravitatorio armónico (memoria reservada con new[]).
+ *
+ * @param r Vector de posición del satélite en el sistema inercial.
+ * @param E Matriz de transformación al sistema centrado en el cuerpo central.
+ * @param n_max Máximo grado del campo armónico.
+ * @param m_max Máximo orden del campo armónico.
+ * @param patch Bloque de grado bajo que sustituye a las tablas globales hasta su grado (nulo: ninguno).
+ * @return double* Aceleración en el sistema inercial.
+ * @throws std::invalid_argument Si n_max supera el grado cargado con `global::GGM03S`.
+ */
+double* AccelHarmonic(double* r, const Matrix& E, int n_max, int m_max, const GravityPatch* patch){
+    auto* a = new double[3];
+    AccelHarmonic(r, E, n_max, m_max, a, patch);
+    return a;
 }
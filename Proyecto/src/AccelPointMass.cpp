@@ -51,20 +51,80 @@
  * @bug Asegúrese de que los vectores estén correctamente dimensionados y que no haya desbordamientos de memoria.
  * @warning Verificar la precisión de los parámetros de entrada para obtener resultados precisos.
  */
-double* AccelPointMass(double* r,double* s,float GM){
+double* AccelPointMass(double* r,double* s,double GM){
 
 
     auto* a = new double[3];
-    auto* d = new double[3];
+    double d[3];
             //% Relative position vector of satellite w.r.t. point mass
-    for (int i = 0; i < sizeof(r); i++) {
+    for (int i = 0; i < 3; i++) {
         d[i] = r[i] - s[i];
     }
 
+    double nd = norm(d,3), ns = norm(s,3);
+    double d3 = nd*nd*nd, s3 = ns*ns*ns;
 
 //% Acceleration
-    for (int i = 0; i < sizeof(r); i++) {
-        a[i] = -GM * ( (d[i]/pow(norm(d,3),3)) + (s[i]/pow(norm(s,3),3)) );
+    for (int i = 0; i < 3; i++) {
+        a[i] = -GM * ( (d[i]/d3) + (s[i]/s3) );
     }
         return a;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Conjunto vacío de masas puntuales.
+ */
+PointMasses::PointMasses() : n(0) {
+    ind[0] = ind[1] = ind[2] = 0.0;
+}
+
+/**
+ * @brief Añade una masa puntual y acumula su término indirecto.
+ *
+ * @param s Posición geocéntrica de la masa puntual [m].
+ * @param GM Coeficiente gravitacional de la masa puntual [m^3/s^2].
+ */
+void PointMasses::add(const double* s, double GM) {
+    x[n] = s[0];
+    y[n] = s[1];
+    z[n] = s[2];
+    this->GM[n] = GM;
+    n++;
+
+    double s2 = s[0]*s[0] + s[1]*s[1] + s[2]*s[2];
+    double f = GM/(s2*sqrt(s2));
+    ind[0] += f*s[0];
+    ind[1] += f*s[1];
+    ind[2] += f*s[2];
+}
+
+/**
+ * @brief Suma la perturbación de varias masas puntuales sobre N satélites.
+ *
+ * El término indirecto (aceleración de la Tierra) se calcula una vez por época en
+ * `PointMasses::add`; aquí solo quedan los términos directos, con un bucle sobre los
+ * satélites sin dependencias entre iteraciones (vectorizable).
+ *
+ * @param b Masas puntuales de la época.
+ * @param N Número de satélites.
+ * @param r Posiciones de los satélites (N x 3, por filas) [m].
+ * @param a Aceleraciones (entrada y salida, N x 3): se les suma la perturbación.
+ */
+void AccelPointMass(const PointMasses& b, int N, const double* r, double* a) {
+    for (int k = 0; k < N; k++) {
+        a[3*k]   -= b.ind[0];
+        a[3*k+1] -= b.ind[1];
+        a[3*k+2] -= b.ind[2];
+    }
+    for (int j = 0; j < b.n; j++) {
+        const double sx = b.x[j], sy = b.y[j], sz = b.z[j], GM = b.GM[j];
+        for (int k = 0; k < N; k++) {
+            double dx = r[3*k] - sx, dy = r[3*k+1] - sy, dz = r[3*k+2] - sz;
+            double d2 = dx*dx + dy*dy + dz*dz;
+            double f = GM/(d2*sqrt(d2));
+            a[3*k]   -= f*dx;
+            a[3*k+1] -= f*dy;
+            a[3*k+2] -= f*dz;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "AccelSolrad.h"
+#include "SAT_Const.h"
+
+/*%--------------------------------------------------------------------------
+%
+% AccelSolrad: Computes the acceleration due to solar radiation pressure
+%
+%   a = nu CR A/m P_Sol AU^2 (r-r_Sun)/|r-r_Sun|^3
+%
+% Shadow: illumination nu of the satellite by the Sun, occulted by the
+% Earth.
+%
+%   SHADOW_CYLINDRICAL  umbra as a cylinder of radius R_Earth behind the
+%                       Earth; only dot products, no trigonometric calls.
+%   SHADOW_CONICAL      apparent radii of the Sun (a) and the Earth (b) and
+%                       their separation c seen from the satellite. As
+%                       a << b, the Earth limb is taken as a straight edge
+%                       across the solar disk at x = (c-b)/a, and the
+%                       visible fraction of the disk (error below 1e-3
+%                       against the exact overlap of the disks in LEO) is
+%                         nu = 1/2 + (x sqrt(1-x^2) + asin(x))/pi
+%                       The angles come from atan2 and x is clamped to
+%                       [-1,1], so there are no acos calls and no branches
+%                       between umbra, penumbra and sunlight.
+%   SHADOW_SMOOTH       same centre, but nu = 6u^5-15u^4+10u^3 with
+%                       u = (x/width+1)/2 clamped to [0,1]. It is C2 at
+%                       both ends of the penumbra (the conical fraction
+%                       has an infinite second derivative there), and
+%                       width > 1 stretches the transition over several
+%                       integration steps, which avoids the rejected steps
+%                       of a multistep method at the shadow boundaries.
+%
+% Reference:
+%   O. Montenbruck, E. Gill, "Satellite Orbits", Springer, 2000;
+%   Section 3.4.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file AccelSolrad.cpp
+ * @brief Presión de radiación solar y funciones de sombra de la Tierra.
+ */
+
+/**
+ * @brief Fracción del disco solar visible desde el satélite.
+ *
+ * @param r Posición geocéntrica del satélite [m].
+ * @param r_Sun Posición geocéntrica del Sol [m] (en el mismo sistema que r).
+ * @param model Modelo de sombra.
+ * @param width Factor de anchura de la transición de SHADOW_SMOOTH (1: penumbra geométrica).
+ * @return double Iluminación entre 0 (umbra) y 1 (a pleno Sol).
+ */
+double Shadow(const double* r, const double* r_Sun, ShadowModel model, double width){
+    if (model == SHADOW_NONE) {
+        return 1.0;
+    }
+
+    double r2 = r[0]*r[0] + r[1]*r[1] + r[2]*r[2];
+    if (model == SHADOW_CYLINDRICAL) {
+        double ns = sqrt(r_Sun[0]*r_Sun[0] + r_Sun[1]*r_Sun[1] + r_Sun[2]*r_Sun[2]);
+        double rs = (r[0]*r_Sun[0] + r[1]*r_Sun[1] + r[2]*r_Sun[2])/ns;
+        return (rs >= 0.0 || r2 - rs*rs >= R_Earth*R_Earth) ? 1.0 : 0.0;
+    }
+
+    //% Satellite to Sun (d) and to the Earth's centre (-r)
+    double d[3] = {r_Sun[0]-r[0], r_Sun[1]-r[1], r_Sun[2]-r[2]};
+    double nd = sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+    double cx = r[2]*d[1] - r[1]*d[2], cy = r[0]*d[2] - r[2]*d[0], cz = r[1]*d[0] - r[0]*d[1];
+    double c = atan2(sqrt(cx*cx + cy*cy + cz*cz), -(r[0]*d[0] + r[1]*d[1] + r[2]*d[2]));
+    double b = atan2(R_Earth, sqrt(fmax(r2 - R_Earth*R_Earth, 0.0)));
+    double a = R_Sun/nd;
+
+    double x = (c - b)/a;
+    if (model == SHADOW_SMOOTH) {
+        double u = fmin(fmax(0.5*(x/width + 1.0), 0.0), 1.0);
+        return u*u*u*(10.0 + u*(6.0*u - 15.0));
+    }
+    x = fmin(fmax(x, -1.0), 1.0);
+    double y = sqrt(1.0 - x*x);
+    return 0.5 + 2.0*(x*y + atan2(x, y))/pi2;
+}
+
+/**
+ * @brief Suma la aceleración de la presión de radiación solar.
+ *
+ * @param r Posición geocéntrica del satélite [m].
+ * @param r_Sun Posición geocéntrica del Sol [m].
+ * @param Area Sección transversal [m^2].
+ * @param mass Masa del satélite [kg].
+ * @param CR Coeficiente de presión de radiación solar.
+ * @param nu Iluminación (función `Shadow`).
+ * @param a Aceleración (entrada y salida: se suma el término).
+ */
+void AccelSolrad(const double* r, const double* r_Sun, double Area, double mass, double CR, double nu, double* a){
+    if (nu == 0.0) {
+        return;
+    }
+    double d[3] = {r[0]-r_Sun[0], r[1]-r_Sun[1], r[2]-r_Sun[2]};
+    double nd2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+    double c = nu*CR*(Area/mass)*P_Sol*AU*AU/(nd2*sqrt(nd2));
+    for (int i = 0; i < 3; i++) {
+        a[i] += c*d[i];
+    }
+}
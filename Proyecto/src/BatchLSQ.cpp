@@ -0,0 +1,274 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <thread>
+#include "BatchLSQ.h"
+#include "Matrix.h"
+#include "global.h"
+#include "IERS.h"
+#include "timediff.h"
+#include "gmst.h"
+#include "R_z.h"
+#include "Integrator.h"
+#include "VarEqn.h"
+
+/*%--------------------------------------------------------------------------
+%
+% BatchLSQ: Batch weighted least-squares orbit determination (differential
+%           correction of the epoch state)
+%
+% The reference trajectory and the state transition matrices Phi(t_i,t0)
+% are propagated with the variational equations (VarEqn) from the epoch to
+% every observation time. The normal equations are then accumulated over
+% the observation arc, split into contiguous blocks, one per thread, and
+% the partial normal matrices are reduced at the end of each iteration.
+%
+% Reference:
+%   O. Montenbruck, E. Gill, "Satellite Orbits - Models, Methods, and
+%   Applications", Springer Verlag, Heidelberg, 2000; Section 8.1.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file BatchLSQ.cpp
+ * @brief Determinación de órbita por mínimos cuadrados ponderados en lote.
+ */
+
+/**
+ * @brief Acumula las ecuaciones normales de un bloque de observaciones.
+ */
+static void NormalBlock(MeasModel& model, std::vector<Observation>& obs, std::vector<int>& node,
+                        std::vector<double>& Ynode, std::vector<double>& Phinode, std::vector<double>& Unode,
+                        int lo, int hi, double* N, double* b, double* chi2){
+
+    Matrix U(3,3);
+    MeasPrediction pred;
+    double H[6];
+
+    for (int i = 0; i < 36; i++) N[i] = 0.0;
+    for (int i = 0; i < 6; i++) b[i] = 0.0;
+    *chi2 = 0.0;
+
+    for (int l = lo; l < hi; l++) {
+        const Observation& o = obs[l];
+        int k = node[l];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                U(i+1,j+1) = Unode[9*k+3*i+j];
+            }
+        }
+        model.predict(o.station, U, &Ynode[6*k], pred);
+
+        //% Residual (azimuth reduced to [-pi,pi])
+        double dz = o.value - pred.value[o.type];
+        if (o.type == MEAS_AZIMUTH) {
+            dz = atan2(sin(dz), cos(dz));
+        }
+        double sigma = model.getStation(o.station).sigma[o.type];
+        double w = 1.0/(sigma*sigma);
+
+        //% Partials w.r.t. the epoch state H = dz/dY * Phi(t,t0)
+        const double* Phi = &Phinode[36*k];
+        for (int j = 0; j < 6; j++) {
+            H[j] = 0.0;
+            for (int i = 0; i < 6; i++) {
+                H[j] += pred.dzdY[o.type][i]*Phi[6*j+i];
+            }
+        }
+
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                N[6*i+j] += w*H[i]*H[j];
+            }
+            b[i] += w*H[i]*dz;
+        }
+        *chi2 += w*dz*dz;
+    }
+}
+
+/**
+ * @brief Acumula en paralelo las ecuaciones normales de todas las observaciones.
+ *
+ * El arco de observaciones se reparte en bloques contiguos, uno por hilo. Cada hilo
+ * acumula su propia matriz normal parcial, que se suman al final.
+ *
+ * @param model Modelo de observación de la red de estaciones.
+ * @param obs Observaciones.
+ * @param node Índice del nodo (época) de cada observación.
+ * @param Ynode Estado de referencia en cada nodo (6 por nodo).
+ * @param Phinode Matriz de transición Phi(t,t0) en cada nodo (36 por nodo, por columnas).
+ * @param Unode Matriz de rotación de la Tierra en cada nodo (9 por nodo, por filas).
+ * @param nthreads Número de hilos.
+ * @param N Matriz normal 6x6 por filas (salida).
+ * @param b Vector del lado derecho (salida).
+ * @param chi2 Suma ponderada de los residuos al cuadrado (salida).
+ */
+void NormalEquations(MeasModel& model, std::vector<Observation>& obs, std::vector<int>& node,
+                     std::vector<double>& Ynode, std::vector<double>& Phinode, std::vector<double>& Unode,
+                     int nthreads, double* N, double* b, double& chi2){
+
+    int nobs = (int) obs.size();
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+    if (nthreads > nobs) {
+        nthreads = nobs > 0 ? nobs : 1;
+    }
+
+    std::vector<double> Np(36*nthreads), bp(6*nthreads), chi2p(nthreads);
+    std::vector<std::thread> workers;
+    int block = (nobs + nthreads - 1)/nthreads;
+
+    for (int t = 1; t < nthreads; t++) {
+        int lo = t*block;
+        int hi = lo + block < nobs ? lo + block : nobs;
+        workers.push_back(std::thread(NormalBlock, std::ref(model), std::ref(obs), std::ref(node),
+                                      std::ref(Ynode), std::ref(Phinode), std::ref(Unode),
+                                      lo, hi, &Np[36*t], &bp[6*t], &chi2p[t]));
+    }
+    NormalBlock(model, obs, node, Ynode, Phinode, Unode, 0, block < nobs ? block : nobs,
+                &Np[0], &bp[0], &chi2p[0]);
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    //% Reduction of the partial normal equations
+    for (int i = 0; i < 36; i++) N[i] = 0.0;
+    for (int i = 0; i < 6; i++) b[i] = 0.0;
+    chi2 = 0.0;
+    for (int t = 0; t < nthreads; t++) {
+        for (int i = 0; i < 36; i++) N[i] += Np[36*t+i];
+        for (int i = 0; i < 6; i++) b[i] += bp[6*t+i];
+        chi2 += chi2p[t];
+    }
+}
+
+/**
+ * @brief Determinación de órbita por mínimos cuadrados ponderados en lote.
+ *
+ * @param model Modelo de observación de la red de estaciones.
+ * @param obs Observaciones ordenadas por tiempo.
+ * @param Mjd0 Época del estado a estimar (Fecha Juliana Modificada UTC).
+ * @param Y0 Estado en la época: a priori (entrada) y estimado (salida).
+ * @param P Covarianza a priori (entrada) y covarianza del estado estimado (salida).
+ * @param maxit Número máximo de iteraciones.
+ * @param tol Tolerancia relativa en la variación del residuo cuadrático medio ponderado.
+ * @param nthreads Número de hilos (0: número de núcleos disponibles).
+ * @param integ Integrador de la trayectoria de referencia y de las ecuaciones variacionales.
+ * @param force Modelo de fuerzas (nulo: el de las variables globales); su época se ignora.
+ * @return int Número de iteraciones realizadas.
+ *
+ * @details
+ * La trayectoria de referencia se propaga de nodo en nodo con `VarEqn`; la época de cada
+ * tramo va en el `AccelParam` de la función (el modelo de fuerzas se toma de las variables
+ * globales si `force` es nulo). La acumulación de las ecuaciones normales se reparte entre hilos.
+ */
+int BatchLSQ(MeasModel& model, std::vector<Observation>& obs, double Mjd0, double* Y0,
+             Matrix& P, int maxit, double tol, int nthreads, Integrator integ, const AccelParam* force){
+
+    double x_pole,y_pole,UT1_UTC,dpsi,LOD,deps,dx_pole,dy_pole,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC;
+
+    if (nthreads <= 0) {
+        nthreads = (int) std::thread::hardware_concurrency();
+    }
+
+    //% Epoch nodes (observations sharing a time tag share the propagation)
+    int nobs = (int) obs.size();
+    std::vector<double> Mjd_node;
+    std::vector<int> node(nobs);
+    for (int l = 0; l < nobs; l++) {
+        if (Mjd_node.empty() || obs[l].Mjd_UTC != Mjd_node.back()) {
+            Mjd_node.push_back(obs[l].Mjd_UTC);
+        }
+        node[l] = (int) Mjd_node.size() - 1;
+    }
+    int nnode = (int) Mjd_node.size();
+
+    std::vector<double> Ynode(6*nnode), Phinode(36*nnode), Unode(9*nnode);
+    std::vector<double> TT_node(nnode);
+
+    //% Earth rotation at every node (independent of the state)
+    for (int k = 0; k < nnode; k++) {
+        IERS(*global::eopdate,Mjd_node[k],'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+        timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
+        TT_node[k] = Mjd_node[k] + TT_UTC/86400;
+        double Mjd_UT1 = Mjd_node[k] + UT1_UTC/86400;
+        Matrix U = R_z(gmst(Mjd_UT1));
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                Unode[9*k+3*i+j] = U(i+1,j+1);
+            }
+        }
+    }
+    IERS(*global::eopdate,Mjd0,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+    timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
+    double TT0 = Mjd0 + TT_UTC/86400;
+
+    //% A priori information
+    double Y_apr[6];
+    for (int i = 0; i < 6; i++) {
+        Y_apr[i] = Y0[i];
+    }
+    Matrix Inf_apr = P.inverse();
+
+    double yPhi[42];
+    double N[36], b[6], chi2;
+    double rms_old = 0.0;
+    int iter;
+
+    for (iter = 1; iter <= maxit; iter++) {
+
+        //% Reference trajectory and state transition matrices
+        for (int i = 0; i < 6; i++) {
+            yPhi[i] = Y0[i];
+            for (int j = 0; j < 6; j++) {
+                yPhi[6*j+i+6] = (i == j) ? 1.0 : 0.0;
+            }
+        }
+        AccelParam param = force != nullptr ? *force : GlobalAccelParam();
+        auto f = [&param](double x, const double* y, double* dy) { VarEqn(x, y, dy, param); };
+        param.Mjd_UTC = Mjd0;
+        param.Mjd_TT = TT0;
+        for (int k = 0; k < nnode; k++) {
+            Integrate(integ,f,0,(Mjd_node[k]-param.Mjd_UTC)*86400.0,1e-13,1e-6,42,yPhi);
+            for (int i = 0; i < 6; i++) {
+                Ynode[6*k+i] = yPhi[i];
+            }
+            for (int i = 0; i < 36; i++) {
+                Phinode[36*k+i] = yPhi[i+6];
+            }
+            param.Mjd_UTC = Mjd_node[k];
+            param.Mjd_TT = TT_node[k];
+        }
+
+        //% Normal equations
+        NormalEquations(model, obs, node, Ynode, Phinode, Unode, nthreads, N, b, chi2);
+
+        Matrix Nm(6,6,N,36);
+        Matrix dY_apr(6,1);
+        for (int i = 0; i < 6; i++) {
+            dY_apr(i+1,1) = Y_apr[i] - Y0[i];
+        }
+        Matrix b_apr = Inf_apr*dY_apr;
+        for (int i = 0; i < 6; i++) {
+            b[i] += b_apr(i+1,1);
+        }
+
+        //% Differential correction
+        P = (Nm + Inf_apr).inverse();
+        Matrix bm(6,1,b,6);
+        Matrix dY = P*bm;
+        for (int i = 0; i < 6; i++) {
+            Y0[i] += dY(i+1,1);
+        }
+
+        //% Convergence of the weighted RMS of the residuals
+        double rms = sqrt(chi2/nobs);
+        if (iter > 1 && fabs(rms - rms_old) <= tol*rms) {
+            break;
+        }
+        rms_old = rms;
+    }
+    return iter > maxit ? maxit : iter;
+}
@@ -0,0 +1,221 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <stdexcept>
+#include "DenseOrbit.h"
+#include "SAT_Const.h"
+
+/*%--------------------------------------------------------------------------
+%
+% DenseOrbit: Dense output of a propagated orbit
+%
+% Stores position, velocity and acceleration at the accepted steps of an
+% integrator and interpolates between them. On each step the position is
+% the quintic Hermite polynomial matching r, v and a at both ends, and the
+% velocity is its derivative. Optionally samples of the gradient of the
+% acceleration are stored as well, at their own (monotonic) instants: the
+% point-mass part is evaluated exactly at the interpolated position and only
+% the remainder (field harmonics and Earth rotation) is interpolated, with the
+% Lagrange polynomial through the nearest six samples.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file DenseOrbit.cpp
+ * @brief Salida densa de una órbita propagada por interpolación de Hermite.
+ */
+
+static const int REC = 13;      // t, Y(6), dY(6) per node
+static const int GREC = 10;     // t, G(3x3) row-major per gradient sample
+static const int GWIN = 6;      // Samples of the gradient interpolation
+
+/**
+ * @brief Elimina todos los nodos.
+ */
+void DenseOrbit::clear() {
+    nodes.clear();
+    grads.clear();
+}
+
+/**
+ * @brief Añade un nodo (los instantes deben ser monótonos).
+ *
+ * @param t Instante [s].
+ * @param Y Estado [r;v] (6).
+ * @param dY Derivada [v;a] (6).
+ */
+void DenseOrbit::add(double t, const double* Y, const double* dY) {
+    nodes.push_back(t);
+    for (int i = 0; i < 6; i++) {
+        nodes.push_back(Y[i]);
+    }
+    for (int i = 0; i < 6; i++) {
+        nodes.push_back(dY[i]);
+    }
+}
+
+/**
+ * @brief Gradiente de la aceleración de una masa puntual (GM_Earth) en r.
+ */
+static void CentralGradient(const double* r, double* G) {
+    double r2 = r[0]*r[0] + r[1]*r[1] + r[2]*r[2];
+    double k = GM_Earth/(r2*sqrt(r2));
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            G[3*i+j] = k*(3.0*r[i]*r[j]/r2 - (i == j ? 1.0 : 0.0));
+        }
+    }
+}
+
+/**
+ * @brief Añade una muestra del gradiente de la aceleración (instantes monótonos, en el
+ * intervalo cubierto por los nodos).
+ *
+ * @param t Instante [s].
+ * @param G Gradiente da/dr por filas (9).
+ * @throws std::out_of_range Si hay menos de dos nodos.
+ */
+void DenseOrbit::addGradient(double t, const double* G) {
+    double Y[6], G0[9];
+    eval(t, Y);
+    CentralGradient(Y, G0);
+    grads.push_back(t);
+    for (int i = 0; i < 9; i++) {
+        grads.push_back(G[i] - G0[i]);
+    }
+}
+
+/**
+ * @brief Intervalo [lo, lo+1] de registros de tamaño rec que contiene t (búsqueda binaria).
+ */
+static int Locate(const std::vector<double>& v, int rec, double t) {
+    int n = (int) v.size()/rec;
+    double sgn = v[rec*(n-1)] >= v[0] ? 1.0 : -1.0;
+    int lo = 0, hi = n-1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi)/2;
+        if (sgn*(t - v[rec*mid]) >= 0.0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Interpola el estado en un instante del intervalo cubierto.
+ *
+ * Fuera del intervalo se extrapola con el primer o el último paso, lo que solo es
+ * adecuado para excesos del orden del redondeo.
+ *
+ * @param t Instante [s].
+ * @param Y Estado interpolado [r;v] (salida, 6).
+ * @throws std::out_of_range Si hay menos de dos nodos.
+ */
+void DenseOrbit::eval(double t, double* Y) const {
+    int n = getNodes();
+    if (n < 2) {
+        throw std::out_of_range("DenseOrbit: fewer than two nodes");
+    }
+
+    //% Bisection for the step containing t
+    int lo = Locate(nodes, REC, t);
+    const double* a = &nodes[REC*lo];
+    const double* b = &nodes[REC*(lo+1)];
+    double h = b[0] - a[0];
+    double s = (t - a[0])/h;
+    double s2 = s*s, s3 = s2*s, s4 = s3*s, s5 = s4*s;
+
+    //% Quintic Hermite basis and derivatives with respect to s
+    double h00 = 1.0 - 10.0*s3 + 15.0*s4 - 6.0*s5;
+    double h01 = 10.0*s3 - 15.0*s4 + 6.0*s5;
+    double h10 = s - 6.0*s3 + 8.0*s4 - 3.0*s5;
+    double h11 = -4.0*s3 + 7.0*s4 - 3.0*s5;
+    double h20 = 0.5*s2 - 1.5*s3 + 1.5*s4 - 0.5*s5;
+    double h21 = 0.5*s3 - s4 + 0.5*s5;
+    double d00 = -30.0*s2 + 60.0*s3 - 30.0*s4;
+    double d10 = 1.0 - 18.0*s2 + 32.0*s3 - 15.0*s4;
+    double d11 = -12.0*s2 + 28.0*s3 - 15.0*s4;
+    double d20 = s - 4.5*s2 + 6.0*s3 - 2.5*s4;
+    double d21 = 1.5*s2 - 4.0*s3 + 2.5*s4;
+
+    for (int i = 0; i < 3; i++) {
+        double ra = a[1+i], va = a[4+i], aa = a[10+i];
+        double rb = b[1+i], vb = b[4+i], ab = b[10+i];
+        Y[i] = h00*ra + h01*rb + h*(h10*va + h11*vb) + h*h*(h20*aa + h21*ab);
+        Y[i+3] = (d00*(ra - rb))/h + d10*va + d11*vb + h*(d20*aa + d21*ab);
+    }
+}
+
+/**
+ * @brief Interpola el gradiente de la aceleración en un instante del intervalo cubierto.
+ *
+ * El término de masa puntual se evalúa en la posición interpolada; el resto, con el
+ * polinomio de Lagrange por las seis muestras más próximas al intervalo que contiene t
+ * (todas si hay menos).
+ *
+ * @param t Instante [s].
+ * @param G Gradiente interpolado por filas (salida, 9).
+ * @throws std::out_of_range Si hay menos de dos nodos o de dos muestras del gradiente.
+ */
+void DenseOrbit::evalGradient(double t, double* G) const {
+    int n = getGradients();
+    if (n < 2) {
+        throw std::out_of_range("DenseOrbit: fewer than two gradient samples");
+    }
+    int lo = Locate(grads, GREC, t);
+    int k0 = lo - (GWIN/2 - 1);
+    if (k0 > n - GWIN) {
+        k0 = n - GWIN;
+    }
+    if (k0 < 0) {
+        k0 = 0;
+    }
+    int k1 = k0 + GWIN < n ? k0 + GWIN : n;
+
+    double Y[6];
+    eval(t, Y);
+    CentralGradient(Y, G);
+    for (int k = k0; k < k1; k++) {
+        double w = 1.0;
+        for (int j = k0; j < k1; j++) {
+            if (j != k) {
+                w *= (t - grads[GREC*j])/(grads[GREC*k] - grads[GREC*j]);
+            }
+        }
+        const double* g = &grads[GREC*k+1];
+        for (int i = 0; i < 9; i++) {
+            G[i] += w*g[i];
+        }
+    }
+}
+
+/**
+ * @brief Número de nodos almacenados.
+ */
+int DenseOrbit::getNodes() const {
+    return (int) nodes.size()/REC;
+}
+
+/**
+ * @brief Número de muestras del gradiente.
+ */
+int DenseOrbit::getGradients() const {
+    return (int) grads.size()/GREC;
+}
+
+/**
+ * @brief Instante del primer nodo.
+ */
+double DenseOrbit::getBegin() const {
+    return nodes[0];
+}
+
+/**
+ * @brief Instante del último nodo.
+ */
+double DenseOrbit::getEnd() const {
+    return nodes[REC*(getNodes()-1)];
+}
@@ -0,0 +1,189 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "Density.h"
+#include "SAT_Const.h"
+
+/*%--------------------------------------------------------------------------
+%
+% Density: Atmospheric density models for the drag acceleration
+%
+% Harris-Priester: modified model of Montenbruck and Gill for mean solar
+% activity. Between two table altitudes h_i <= h < h_i+1 the minimum and
+% maximum densities decay exponentially,
+%
+%   rho_m(h) = rho_m(h_i) exp(-(h-h_i)/H_m),  H_m = (h_i-h_i+1)/ln(rho_m(h_i+1)/rho_m(h_i))
+%
+% and the diurnal bulge, lagging the Sun by 30 deg in right ascension,
+% blends them with the angle psi between the satellite and the apex:
+%
+%   rho = rho_min + (rho_max-rho_min) cos(psi/2)^n
+%
+% The logarithms and inverse scale heights of every bin are precomputed,
+% and the bin of an altitude is read from a 1 km index, so an evaluation
+% costs two exponentials and one power. The altitude is taken over the
+% ellipsoid along the radius (error below 100 m).
+%
+% CachedDensity wraps an expensive model (NRLMSISE class) and reuses its
+% last value while the epoch and position stay within a window; with a
+% window of the order of the integration step the model is evaluated
+% about once per step instead of once per stage. The last value is
+% kept per thread (a few thread_local slots tagged with the id of the
+% cache), so one instance can be shared by the threads of a parallel
+% propagation: each thread reuses only its own evaluations.
+%
+% Reference:
+%   O. Montenbruck, E. Gill, "Satellite Orbits", Springer, 2000;
+%   Section 3.5.2.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file Density.cpp
+ * @brief Modelos de densidad atmosférica: Harris-Priester tabulado y caché para modelos costosos.
+ */
+
+//% Harris-Priester parameters for mean solar activity [km], [g/km^3]
+static const double h_tab[50] = {
+    100.0, 120.0, 130.0, 140.0, 150.0, 160.0, 170.0, 180.0, 190.0, 200.0,
+    210.0, 220.0, 230.0, 240.0, 250.0, 260.0, 270.0, 280.0, 290.0, 300.0,
+    320.0, 340.0, 360.0, 380.0, 400.0, 420.0, 440.0, 460.0, 480.0, 500.0,
+    520.0, 540.0, 560.0, 580.0, 600.0, 620.0, 640.0, 660.0, 680.0, 700.0,
+    720.0, 740.0, 760.0, 780.0, 800.0, 840.0, 880.0, 920.0, 960.0, 1000.0};
+static const double c_min[50] = {
+    4.974e+05, 2.490e+04, 8.377e+03, 3.899e+03, 2.122e+03, 1.263e+03,
+    8.008e+02, 5.283e+02, 3.617e+02, 2.557e+02, 1.839e+02, 1.341e+02,
+    9.949e+01, 7.488e+01, 5.709e+01, 4.403e+01, 3.430e+01, 2.697e+01,
+    2.139e+01, 1.708e+01, 1.099e+01, 7.214e+00, 4.824e+00, 3.274e+00,
+    2.249e+00, 1.558e+00, 1.091e+00, 7.701e-01, 5.474e-01, 3.916e-01,
+    2.819e-01, 2.042e-01, 1.488e-01, 1.092e-01, 8.070e-02, 6.012e-02,
+    4.519e-02, 3.430e-02, 2.632e-02, 2.043e-02, 1.607e-02, 1.281e-02,
+    1.036e-02, 8.496e-03, 7.069e-03, 4.680e-03, 3.200e-03, 2.210e-03,
+    1.560e-03, 1.150e-03};
+static const double c_max[50] = {
+    4.974e+05, 2.490e+04, 8.710e+03, 4.059e+03, 2.215e+03, 1.344e+03,
+    8.758e+02, 6.010e+02, 4.297e+02, 3.162e+02, 2.396e+02, 1.853e+02,
+    1.455e+02, 1.157e+02, 9.308e+01, 7.555e+01, 6.182e+01, 5.095e+01,
+    4.226e+01, 3.526e+01, 2.511e+01, 1.819e+01, 1.337e+01, 9.955e+00,
+    7.492e+00, 5.684e+00, 4.355e+00, 3.362e+00, 2.612e+00, 2.042e+00,
+    1.605e+00, 1.267e+00, 1.005e+00, 7.997e-01, 6.390e-01, 5.123e-01,
+    4.121e-01, 3.325e-01, 2.691e-01, 2.185e-01, 1.779e-01, 1.452e-01,
+    1.190e-01, 9.776e-02, 8.059e-02, 5.741e-02, 4.210e-02, 3.130e-02,
+    2.360e-02, 1.810e-02};
+
+static const double ra_lag = 0.523599;     // Right ascension lag of the bulge [rad]
+
+/**
+ * @brief Precalcula los parámetros de cada intervalo de altitud.
+ *
+ * @param n_prm Exponente de cos(psi/2) (2 para órbitas de baja inclinación, 6 para polares).
+ */
+HarrisPriester::HarrisPriester(double n_prm) : half_n(0.5*n_prm) {
+    for (int i = 0; i < NBIN; i++) {
+        double dh = h_tab[i+1] - h_tab[i];
+        bin[i].h0 = h_tab[i];
+        bin[i].ln_min = log(c_min[i]*1e-12);
+        bin[i].k_min = log(c_min[i]/c_min[i+1])/dh;
+        bin[i].ln_max = log(c_max[i]*1e-12);
+        bin[i].k_max = log(c_max[i]/c_max[i+1])/dh;
+    }
+    int i = 0;
+    for (int k = 0; k < NKM; k++) {
+        while (h_tab[i+1] <= 100.0 + k) {
+            i++;
+        }
+        index[k] = (unsigned char) i;
+    }
+}
+
+/**
+ * @brief Densidad de Harris-Priester.
+ *
+ * @param Mjd_TT Época (no se usa: el modelo es de actividad solar media).
+ * @param r_tod Posición del satélite en el sistema verdadero de la fecha [m].
+ * @param r_Sun Posición geocéntrica del Sol en el sistema verdadero de la fecha [m].
+ * @return double Densidad [kg/m^3]; 0 fuera de 100-1000 km.
+ */
+double HarrisPriester::density(double Mjd_TT, const double* r_tod, const double* r_Sun) const {
+    (void) Mjd_TT;
+    double d = sqrt(r_tod[0]*r_tod[0] + r_tod[1]*r_tod[1] + r_tod[2]*r_tod[2]);
+    double sphi = r_tod[2]/d;
+    double h = (d - R_Earth*(1.0 - f_Earth*sphi*sphi))/1000.0;
+    if (h < 100.0 || h >= 1000.0) {
+        return 0.0;
+    }
+
+    //% Apex of the diurnal bulge
+    double rxy = sqrt(r_Sun[0]*r_Sun[0] + r_Sun[1]*r_Sun[1]);
+    double ra = atan2(r_Sun[1], r_Sun[0]) + ra_lag;
+    double cdec = rxy/sqrt(rxy*rxy + r_Sun[2]*r_Sun[2]);
+    double sdec = r_Sun[2]/sqrt(rxy*rxy + r_Sun[2]*r_Sun[2]);
+    double c_psi2 = 0.5 + 0.5*(cdec*cos(ra)*r_tod[0] + cdec*sin(ra)*r_tod[1] + sdec*r_tod[2])/d;
+    c_psi2 = c_psi2 > 0.0 ? c_psi2 : 0.0;
+
+    const Bin& b = bin[index[(int) (h - 100.0)]];
+    double d_min = exp(b.ln_min - (h - b.h0)*b.k_min);
+    double d_max = exp(b.ln_max - (h - b.h0)*b.k_max);
+    return d_min + (d_max - d_min)*pow(c_psi2, half_n);
+}
+
+/**
+ * @brief Caché de un modelo de densidad.
+ *
+ * @param model Modelo evaluado (debe existir mientras se use la caché y admitir llamadas
+ * concurrentes si la caché se comparte entre hilos).
+ * @param dt Ventana de tiempo en la que se reutiliza el último valor [s] (0: solo repeticiones exactas).
+ * @param dr Distancia máxima a la última posición evaluada [m].
+ */
+CachedDensity::CachedDensity(const DensityModel& model, double dt, double dr)
+    : model(model), dt(dt), dr(dr), calls(0) {
+    static std::atomic<unsigned long long> next(1);
+    id = next.fetch_add(1);
+}
+
+/**
+ * @brief Densidad del modelo, reutilizando el último valor del hilo dentro de la ventana.
+ *
+ * @param Mjd_TT Época (Terrestrial Time, Modified Julian Date).
+ * @param r_tod Posición del satélite en el sistema verdadero de la fecha [m].
+ * @param r_Sun Posición geocéntrica del Sol en el sistema verdadero de la fecha [m].
+ * @return double Densidad [kg/m^3].
+ */
+double CachedDensity::density(double Mjd_TT, const double* r_tod, const double* r_Sun) const {
+    static thread_local Slot slots[NSLOT] = {};
+    static thread_local int next = 0;
+
+    Slot* s = nullptr;
+    for (int k = 0; k < NSLOT; k++) {
+        if (slots[k].id == id) {
+            s = &slots[k];
+            break;
+        }
+    }
+    if (s != nullptr && fabs(Mjd_TT - s->Mjd_c)*86400.0 <= dt) {
+        double dx = r_tod[0] - s->r_c[0], dy = r_tod[1] - s->r_c[1], dz = r_tod[2] - s->r_c[2];
+        if (dx*dx + dy*dy + dz*dz <= dr*dr) {
+            return s->rho_c;
+        }
+    }
+    if (s == nullptr) {
+        s = &slots[next];
+        next = (next + 1) % NSLOT;
+        s->id = id;
+    }
+    s->rho_c = model.density(Mjd_TT, r_tod, r_Sun);
+    s->Mjd_c = Mjd_TT;
+    for (int i = 0; i < 3; i++) {
+        s->r_c[i] = r_tod[i];
+    }
+    calls.fetch_add(1, std::memory_order_relaxed);
+    return s->rho_c;
+}
+
+/**
+ * @brief Número de evaluaciones del modelo envuelto (en todos los hilos).
+ */
+long CachedDensity::getCalls() const {
+    return calls.load();
+}
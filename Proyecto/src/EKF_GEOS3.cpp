@@ -5,24 +5,25 @@
 #include <fstream>
 #include <iostream>
 #include <vector>
+#include <stdexcept>
 #include "EKF_GEOS3.h"
 #include "global.h"
 #include "Mjday.h"
 #include "SAT_Const.h"
-#include "Position.h"
+#include "MeasModel.h"
 #include "Accel.h"
-#include "DEInteg.h"
-#include "LTC.h"
+#include "Integrator.h"
 #include "IERS.h"
 #include "timediff.h"
 #include "VarEqn.h"
 #include "gmst.h"
 #include "R_z.h"
 #include "TimeUpdate.h"
-#include "AzElPa.h"
+#include "ProcessNoise.h"
 #include "MeasUpdate.h"
-#include "norm.h"
+#include "UKF.h"
 #include "auxFunc.h"
+#include "Stats.h"
 
 /*%--------------------------------------------------------------------------
 %
@@ -53,47 +54,105 @@
  * El programa lee observaciones de posición de un archivo de entrada, realiza la propagación de la órbita utilizando modelos dinámicos y de observación,
  * y aplica el Filtro de Kalman Extendido para estimar la posición y velocidad del satélite.
  *
+ * Si se compila con PROYECTO_STATS, al final se escribe el resumen de pasos, evaluaciones
+ * y tiempos de `Accel` (`StatsPrint`).
+ *
  * @note Este programa asume que se han proporcionado observaciones válidas y que los modelos dinámicos y de observación son adecuados para el problema.
  *
  * @version 1.0
  * @date Fecha de creación
  *
+ * @param opt Opciones:
+ * - `rts`: suavizador opcional; si no es nulo, guarda un punto de control por época y al final
+ *   sustituye los estados filtrados por los suavizados (Rauch-Tung-Striebel). Solo en modo extendido.
+ * - `unscented`: usa el filtro de Kalman unscented (`UKF`); los 13 puntos sigma se propagan en
+ *   paralelo con `Accel`, sin las ecuaciones variacionales.
+ * - `parallel_stm`: en modo extendido, la trayectoria se propaga una sola vez con salida densa
+ *   y muestras del gradiente (siempre con `RKInteg`) y las columnas de la matriz de transición
+ *   se integran sobre ella (`PropagateSTM`). Desactivado por defecto: linealiza en torno a la
+ *   trayectoria de `Accel` en lugar de la de `VarEqn`.
+ * - `integ`: integrador de los arcos inicial y final y de la propagación entre observaciones
+ *   (`DEInteg` o `RKInteg`).
+ * - `force`: modelo de fuerzas (nulo: campo 20x20, Sol, Luna y planetas); su época se ignora.
+ *   El campo gravitatorio debe estar cargado (`global::GGM03S`) al menos hasta su grado.
+ * - `noise`: ruido del proceso de las actualizaciones temporales: ninguno, SNC (`NoiseMatrix`) o
+ *   DMC con su densidad espectral y tiempo de correlación. Con DMC el filtro extendido estima
+ *   además las tres aceleraciones de Gauss-Markov (estado de 9 componentes, `DMCTimeUpdate`),
+ *   con varianza inicial q*tau/2, y el suavizador debe crearse con 9 estados.
+ *
  * @warning El usuario debe asegurarse de proporcionar observaciones precisas y ajustar los parámetros de los modelos de acuerdo con las necesidades del problema.
  */
 
-void EKF_GEOS3(){
+void EKF_GEOS3(const EKFOptions& opt){
+    RTSSmoother* rts = opt.rts;
+    bool unscented = opt.unscented;
+    bool parallel_stm = opt.parallel_stm;
     double x_pole,y_pole,UT1_UTC,dpsi,LOD,deps,dx_pole,dy_pole,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC;
     double Mjd_TT;
+    StatsReset();
     global::DE430Coeff();
-    Matrix PC = *global::PC;
 
-//% Model parameters
+//% Force model (the gravity field must be loaded by the caller up to its degree)
+    AccelParam force = GlobalAccelParam();
+    if (opt.force != nullptr) {
+        force = *opt.force;
+    } else {
+        force.n = 20;
+        force.m = 20;
+        force.sun = 1;
+        force.moon = 1;
+        force.planets = 1;
+    }
+    if (global::Cnm == nullptr || force.n >= global::Cnm->getRows()) {
+        throw std::invalid_argument("EKF_GEOS3: gravity field not loaded up to the degree of the force model");
+    }
+
+//% Dynamic model compensation: Gauss-Markov accelerations appended to the state
+    bool dmc = opt.noise.model == NOISE_DMC;
+    int nx = dmc ? 9 : 6;
+    if (dmc && unscented) {
+        throw std::invalid_argument("EKF_GEOS3: DMC needs the extended filter");
+    }
+    if (rts != nullptr && rts->getStates() != nx) {
+        throw std::invalid_argument("EKF_GEOS3: smoother state dimension does not match the filter");
+    }
+    double w[3] = {0.0, 0.0, 0.0};
 
 //% read Earth orientation parameters
-%  ----------------------------------------------------------------------------------------------------
-% |  Date    MJD      x         y       UT1-UTC      LOD       dPsi    dEpsilon     dX        dY    DAT
-% |(0h UTC)           "         "          s          s          "        "          "         "     s
-%  ----------------------------------------------------------------------------------------------------
-global::eop19620101(6);
+//%  ----------------------------------------------------------------------------------------------------
+//% |  Date    MJD      x         y       UT1-UTC      LOD       dPsi    dEpsilon     dX        dY    DAT
+//% |(0h UTC)           "         "          s          s          "        "          "         "     s
+//%  ----------------------------------------------------------------------------------------------------
+    global::eop19620101();
 
-Matrix eopdata = *global::eopdate;
+    Matrix eopdata = *global::eopdate;
     double s,az,el,Dist;
     int M,D,h,m;
     double* yPhi;
-    int nobs = 46;
-Matrix obs(nobs,4);
+
+//% Kaena Point station
+    double sigma_range = 92.5;         // % [m]
+    double sigma_az = 0.0224*Rad; //% [rad]
+    double sigma_el = 0.0139*Rad; //% [rad]
+
+    double lat = Rad*21.5748;     //% [rad]
+    double lon = Rad*(-158.2706);// % [rad]
+    double alt = 300.20;              //  % [m]
+
+    MeasModel model;
+    int kaena = model.addStation(lon, lat, alt, sigma_az, sigma_el, sigma_range);
 
 //% read observations
+    std::vector<Observation> obs;
+    std::vector<double> Mjd_obs;
 
     std::ifstream file("../data/GEOS3.txt");
     if (!file.is_open()) {
         std::cerr << "Error: No se pudo abrir el archivo GEOS3.txt" << std::endl;
-        return 1;
+        return;
     }
 
-
     std::string line;
-    int i=1;
     while (std::getline(file, line)) {
 
         if (line.empty()) {
@@ -110,35 +169,16 @@ Matrix obs(nobs,4);
         el = std::stod(line.substr(35, 7));
         Dist = std::stod(line.substr(44, 10));
 
-        obs(i,1) = Mjday(Y,M,D,h,m,s);
-        obs(i,2) = Rad*az;
-        obs(i,3) = Rad*el;
-        obs(i,4) = 1e3*Dist;
-        i++;
+        double Mjd = Mjday(Y,M,D,h,m,s);
+        Mjd_obs.push_back(Mjd);
+        obs.push_back({Mjd, kaena, MEAS_AZIMUTH, Rad*az});
+        obs.push_back({Mjd, kaena, MEAS_ELEVATION, Rad*el});
+        obs.push_back({Mjd, kaena, MEAS_RANGE, 1e3*Dist});
     }
 
     file.close();
 
-
-
-
-
-double sigma_range = 92.5;         // % [m]
-double sigma_az = 0.0224*Rad; //% [rad]
-double sigma_el = 0.0139*Rad; //% [rad]
-
-//% Kaena Point station
-     double   lat = Rad*21.5748;     //% [rad]
-    double lon = Rad*(-158.2706);// % [rad]
-    double alt = 300.20;              //  % [m]
-
-double* Rss = Position(lon, lat, alt);
-Matrix Rs(1,3,Rss,3);
-
-    double Mjd1 = obs(1,1);
-    double Mjd2 = obs(9,1);
-    double Mjd3 = obs(18,1);
-
+    int nobs = (int) Mjd_obs.size();
 
 double r2[3]={6221397.62857869,2867713.77965738,3006155.98509949};
 double v2[3]={4645.04725161806,-2752.21591588204,-7507.99940987031};
@@ -149,21 +189,14 @@ double* Y0_apr = concatenateVectors(r2,v2,3,3);
 
 double Mjd0 = Mjday(1995,1,29,02,38,0);
 
-double Mjd_UTC = obs(9,1);
-
-    global::Mjd_UTC = Mjd_UTC;
-    global::n      = 20;
-    global::m      = 20;
-    global::sun     = 1;
-    global::moon    = 1;
-    global::planets = 1;
-
-int n_eqn  = 6;
+double Mjd_UTC = Mjd_obs[8];
 
+    AccelParam param0 = force;
+    param0.Mjd_UTC = Mjd_UTC;
+double* Y = Integrate(opt.integ, [&param0](double x, const double* y, double* dy) { Accel(x, y, dy, param0); },
+                       0,-(Mjd_obs[8]-Mjd0)*86400.0,1e-13,1e-6,6,Y0_apr);
 
-double* Y = DEInteg(Accel,0,-(obs(9,1)-Mjd0)*86400.0,1e-13,1e-6,6,Y0_apr);
-
-Matrix P(6,6);
+Matrix P(nx,nx);
 
     for (int i = 1; i <= 3; ++i) {
         P(i, i) = 1e8;
@@ -171,145 +204,169 @@ Matrix P(6,6);
     for (int i = 4; i <= 6; ++i) {
         P(i, i) = 1e3;
     }
-    Matrix LT = LTC(lon,lat);
+    for (int i = 7; i <= nx; ++i) {
+        P(i, i) = 0.5*opt.noise.q*opt.noise.tau;     //% Steady-state variance of w
+    }
+    double Yx[9];
 
     yPhi = new double[42];
     Matrix Phi(6,6);
+    std::vector<MeasPrediction> pred(model.getStations());
+    std::vector<bool> predicted(model.getStations());
 
 //% Measurement loop
 double t = 0;
 
-for(i=1;i<=nobs;i++){
+for (size_t i = 0; i < obs.size(); ) {
     double t_old = t;
     double* Y_old = Y;
 
-    //% Previous step
-
+    //% Observations sharing the same epoch are processed together
+    size_t first = i;
+    while (i < obs.size() && obs[i].Mjd_UTC == obs[first].Mjd_UTC) {
+        i++;
+    }
+    int nz = (int) (i - first);
 
     //% Time increment and propagation
-    Mjd_UTC = obs(i,1);                       //% Modified Julian Date
+    Mjd_UTC = obs[first].Mjd_UTC;             //% Modified Julian Date
     t   = (Mjd_UTC-Mjd0)*86400.0;         //% Time since epoch [s]
 
     IERS(eopdata,Mjd_UTC,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps, dx_pole,dy_pole, TAI_UTC);
     timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
     Mjd_TT = Mjd_UTC + TT_UTC/86400;
     double Mjd_UT1 = Mjd_TT + (UT1_UTC-TT_UTC)/86400.0;
-    global::Mjd_UTC = Mjd_UTC;
-    global::Mjd_TT = Mjd_TT;
+    AccelParam param = force;
+    param.Mjd_UTC = Mjd_UTC;
+    param.Mjd_TT = Mjd_TT;
+
+    if (unscented) {
+        //% Unscented time update (sigma points propagated with Accel only)
+        UKFTimeUpdate(Y, P, t-t_old, param, 0, opt.integ);
+        P = P + NoiseMatrix(opt.noise, t-t_old);
+    } else if (parallel_stm) {
+        //% Reference trajectory once with dense output, STM columns in parallel
+        PropagateSTM(0, t-t_old, Y_old, Phi, param);
+        Y = Y_old;
+    } else {
+        for (int ii = 0; ii < 6; ++ii) {
+            yPhi[ii] = Y_old[ii];
+            for (int j = 0; j < 6; ++j) {
+                if (ii == j) {
+                    yPhi[6 * j + ii + 6] = 1; // +6 para compensar los primeros 6 elementos
+                } else {
+                    yPhi[6 * j + ii + 6] = 0; // +6 para compensar los primeros 6 elementos
+                }
+            }
+        }
+
+        Integrate(opt.integ, [&param](double x, const double* y, double* dy) { VarEqn(x, y, dy, param); },
+                  0,t-t_old,1e-13,1e-6,42,yPhi);
 
-    for (int ii = 0; ii < 6; ++ii) {
-        yPhi[ii] = Y_old[ii];
+        //% Extract state transition matrices
         for (int j = 0; j < 6; ++j) {
-            if (ii == j) {
-                yPhi[6 * j + ii + 6] = 1; // +6 para compensar los primeros 6 elementos
-            } else {
-                yPhi[6 * j + ii + 6] = 0; // +6 para compensar los primeros 6 elementos
+            for (int ii = 0; ii < 6; ++ii) {
+                Phi(ii+1,j+1) = yPhi[6 * j + ii + 6];
             }
         }
-    }
 
-    yPhi = DEInteg(VarEqn,0,t-t_old,1e-13,1e-6,42,yPhi);
+        Y = Integrate(opt.integ, [&param](double x, const double* y, double* dy) { Accel(x, y, dy, param); },
+                      0,t-t_old,1e-13,1e-6,6,Y_old);
+    }
 
-    //% Extract state transition matrices
-    for (int j = 0; j < 6; ++j) {
-        for (i = 0; i < 6; ++i) {
-            Phi(i+1,j+1) = yPhi[6 * j + i];
+    if (dmc) {
+        //% Time update of the augmented state (r,v,w)
+        for (int j = 0; j < 6; ++j) {
+            Yx[j] = Y[j];
+        }
+        for (int j = 0; j < 3; ++j) {
+            Yx[j+6] = w[j];
+        }
+        Matrix Phi9 = DMCTimeUpdate(Yx, P, Phi, t-t_old, opt.noise.tau, opt.noise.q);
+        for (int j = 0; j < 6; ++j) {
+            Y[j] = Yx[j];
+        }
+        for (int j = 0; j < 3; ++j) {
+            w[j] = Yx[j+6];
+        }
+        if (rts != nullptr) {
+            rts->storePrediction(Mjd_UTC, Yx, P, Phi9);
+        }
+    } else if (!unscented) {
+        //% Time update
+        TimeUpdate(P, Phi, NoiseMatrix(opt.noise, t-t_old));
+        if (rts != nullptr) {
+            rts->storePrediction(Mjd_UTC, Y, P, Phi);
         }
     }
 
-    Y = DEInteg (Accel,0,t-t_old,1e-13,1e-6,6,Y_old);
-
-    //% Topocentric coordinates
+    //% Topocentric coordinates, measurements and partials (once per station)
     double theta = gmst(Mjd_UT1);                    //% Earth rotation
     Matrix U = R_z(theta);
-    int o;
-    double* rz = extractSubarray(Y, 0, 2, o) ;
-    Matrix r(1,3,rz,3);
-    Matrix s = LT*(U*r-Rs);                          //% Topocentric position [m]
-
-    //% Time update
-    TimeUpdate(P, Phi);
-
-    //% Azimuth and partials
-    double Az,El;
-    double* dAds;
-    double* dEds;
-    auto *ss = new double[3];
-    ss[0]=s(1,1);
-    ss[1]=s(1,2);
-    ss[2]=s(1,3);
-
-    AzElPa(ss,dAds, dEds,Az, El);     //% Azimuth, Elevation
-    int fu;
-    Matrix dAds2(3,3,dAds,fu);
-    Matrix dAdY = s.concatenateHorizontal(dAds2*LT*U, Matrix(1,3));
+    if (unscented) {
+        UKFMeasUpdate(Y, P, model, U, &obs[first], nz);
+        continue;
+    }
+    for (int k = 0; k < model.getStations(); ++k) {
+        predicted[k] = false;
+    }
+
+    Matrix Yrow(1,nx);
+    Matrix z(1,nz);
+    Matrix g(1,nz);
+    Matrix sig(1,nz);
+    Matrix G(nz,nx);
+    for (int l = 0; l < nz; ++l) {
+        const Observation& o = obs[first + l];
+        if (!predicted[o.station]) {
+            model.predict(o.station, U, Y, pred[o.station]);
+            predicted[o.station] = true;
+        }
+        z(1,l+1) = o.value;
+        g(1,l+1) = pred[o.station].value[o.type];
+        sig(1,l+1) = model.getStation(o.station).sigma[o.type];
+        for (int j = 0; j < 6; ++j) {
+            G(l+1,j+1) = pred[o.station].dzdY[o.type][j];
+        }
+    }
+    for (int j = 0; j < 6; ++j) {
+        Yrow(1,j+1) = Y[j];
+    }
+    for (int j = 6; j < nx; ++j) {
+        Yrow(1,j+1) = w[j-6];
+    }
 
     //% Measurement update [K, Y, P]
-    Matrix Azim(1,1);
-    Matrix K(6,6);
-    Azim(1,1)=Az;
-    Matrix Y2(42,1);
-    for(int y=0;y<42;y++){
-        Y2(y+1,1)=Y[y];
+    Matrix K(nx,nz);
+    MeasUpdate(Yrow, z, g, sig, G, P, nx, K);
+    for (int j = 0; j < nx; ++j) {
+        Yx[j] = Yrow(1,j+1);
+    }
+    for (int j = 0; j < 6; ++j) {
+        Y[j] = Yx[j];
+    }
+    for (int j = 6; j < nx; ++j) {
+        w[j-6] = Yx[j];
+    }
+    if (rts != nullptr) {
+        rts->storeUpdate(Yx, P);
     }
-    Matrix z(1,1);
-    z(1,1)=obs(i,2);
-    Matrix sigaz(1,1);
-    sigaz(1,1)=sigma_az;
-    MeasUpdate(Y2, z, Azim, sigaz, dAdY, P, 6 ,K);
-
-    //% Elevation and partials
-    double* rr = extractSubarray(Y, 0, 2, o) ;
-    Matrix r2(1,3,rr,3);
-    s = LT*(U*r2-Rs);
-    ss[0]=s(1,1);
-    ss[1]=s(1,2);
-    ss[2]=s(1,3);//% Topocentric position [m]
-    AzElPa(ss,dAds, dEds,Az, El);     //% Azimuth, Elevation
-    Matrix dEds2(3,3,dEds,fu);
-    Matrix dEdY = s.concatenateHorizontal(dEds2*LT*U, Matrix(1,3));
-    Matrix Elev(1,1);
-    Elev(1,1)=El;
-    //% Measurement update
-
-
-    z(1,1)=obs(i,3);
-    Matrix sigel(1,1);
-    sigel(1,1)=sigma_el;
-    MeasUpdate ( Y2, z, Elev, sigel, dEdY, P, 6,K );
-
-    //% Range and partials
-    rr = extractSubarray(Y, 0, 2, o) ;
-    Matrix r3(1,3,rr,3);
-    s = LT*(U*r3-Rs);
-    ss[0]=s(1,1);
-    ss[1]=s(1,2);
-    ss[2]=s(1,3);//% Topocentric position [m]
-    Dist = norm(ss,3);
-    auto *dDds = new double[3];
-    dDds[0] = (ss[0]/Dist);
-    dDds[1] = (ss[1]/Dist);
-    dDds[2] = (ss[2]/Dist);//% Range
-    Matrix dDds2(3,3,dDds,fu);
-    Matrix dDdY = s.concatenateHorizontal(dDds2*LT*U, Matrix(1,3));
-
-    //% Measurement update
-
-    z(1,1)=obs(i,4);
-    Matrix sigran(1,1);
-    sigran(1,1)=sigma_range;
-    Matrix Dist2(1,1);
-    Dist2(1,1)=El;
-    MeasUpdate ( Y2, z, Dist2,sigran , dDdY, P, 6 ,K);
 }
 
- IERS(eopdata,obs(46,1),'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+    //% Rauch-Tung-Striebel backward sweep
+    if (rts != nullptr && !unscented) {
+        rts->smooth();
+    }
+
+ IERS(eopdata,Mjd_obs[nobs-1],'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
  timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
 Mjd_TT = Mjd_UTC + TT_UTC/86400;
-global::Mjd_UTC = Mjd_UTC;
-    global::Mjd_TT = Mjd_TT;
 
-double* Y0 = DEInteg (Accel,0,-(obs(46,1)-obs(1,1))*86400.0,1e-13,1e-6,6,Y);
+    AccelParam param1 = force;
+    param1.Mjd_UTC = Mjd_UTC;
+    param1.Mjd_TT = Mjd_TT;
+double* Y0 = Integrate(opt.integ, [&param1](double x, const double* y, double* dy) { Accel(x, y, dy, param1); },
+                        0,-(Mjd_obs[nobs-1]-Mjd_obs[0])*86400.0,1e-13,1e-6,6,Y);
 
 double Y_true[6] = {5753.173e3, 2673.361e3, 3440.304e3, 4.324207e3, -1.924299e3, -5.728216e3};
 
@@ -323,4 +380,6 @@ double Y_true[6] = {5753.173e3, 2673.361e3, 3440.304e3, 4.324207e3, -1.924299e3,
     printf("dVy%8.1f [m/s]\n", Y0[4] - Y_true[4]);
     printf("dVz%8.1f [m/s]\n", Y0[5] - Y_true[5]);
 
+    StatsPrint();
+
 }
\ No newline at end of file
@@ -42,4 +42,33 @@
  *
  * @throws std::runtime_error Si hay problemas de convergencia durante las iteraciones.
  * @warning Asegúrese de proporcionar valores válidos para la anomalía media y la excentricidad para obtener resultados precisos.
- */
\ No newline at end of file
+ */double EccAnom (double M,double e){
+
+    const int maxit = 15;
+    int i = 1;
+    double eps = std::numeric_limits<double>::epsilon();
+
+//% Starting value
+    M = fmod(M, 2.0*M_PI);
+    double E;
+    if (e<0.8){
+        E = M;
+    }else{
+        E = M_PI;
+    }
+
+    double f = E - e*sin(E) - M;
+    E = E - f / ( 1.0 - e*cos(E) );
+
+//% Iteration
+    while (fabs(f) > 1e2*eps){
+        f = E - e*sin(E) - M;
+        E = E - f / ( 1.0 - e*cos(E) );
+        i = i+1;
+        if (i==maxit){
+            throw std::runtime_error("convergence problems in EccAnom");
+        }
+    }
+
+    return E;
+}
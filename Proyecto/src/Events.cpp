@@ -0,0 +1,186 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "Events.h"
+#include "SAT_Const.h"
+#include "gmst.h"
+#include "Mjday_TDB.h"
+#include "JPL_Eph_DE430.h"
+
+/*%--------------------------------------------------------------------------
+%
+% Events: Root finding of event functions on the integrator dense output
+%
+% The detector is passed to RKInteg as observer. For every accepted step
+% the event functions g(t,Y) are sampled at nsub sub-intervals of the
+% quintic Hermite interpolant of the step, and each sign change is refined
+% with the Illinois variant of regula falsi. No force evaluations are
+% made besides those of the integrator.
+%
+%   ElevationEvent  g = elevation of the satellite above a station minus the
+%                   elevation mask; rise: +1, set: -1
+%   EclipseEvent    cylindrical Earth shadow, g = distance to the shadow
+%                   axis minus R_Earth on the night side; entry: -1, exit: +1
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file Events.cpp
+ * @brief Detección de eventos (visibilidad, eclipses) sobre la salida densa del integrador.
+ */
+
+/**
+ * @brief Evento de elevación sobre una estación.
+ *
+ * @param model Modelo de observación con las estaciones (debe seguir existiendo).
+ * @param station Índice de la estación.
+ * @param Mjd_UT1 Época UT1 correspondiente a t = 0 (Modified Julian Date).
+ * @param mask Elevación mínima [rad].
+ */
+ElevationEvent::ElevationEvent(const MeasModel& model, int station, double Mjd_UT1, double mask)
+    : model(model), station(station), Mjd_UT1(Mjd_UT1), mask(mask) {}
+
+/**
+ * @brief Elevación de la estación al satélite menos la máscara [rad].
+ */
+double ElevationEvent::g(double t, const double* Y) const {
+    const Station& st = model.getStation(station);
+    double theta = gmst(Mjd_UT1 + t/86400.0);
+    double c = cos(theta), s = sin(theta);
+
+    //% Body-fixed position (U = R_z(theta)) and topocentric coordinates
+    double r[3] = {c*Y[0] + s*Y[1] - st.Rs[0], -s*Y[0] + c*Y[1] - st.Rs[1], Y[2] - st.Rs[2]};
+    double e = 0.0, n = 0.0, u = 0.0;
+    for (int j = 0; j < 3; j++) {
+        e += st.LT[0][j]*r[j];
+        n += st.LT[1][j]*r[j];
+        u += st.LT[2][j]*r[j];
+    }
+    return atan2(u, sqrt(e*e + n*n)) - mask;
+}
+
+/**
+ * @brief Evento de entrada y salida de la sombra (cilíndrica) de la Tierra.
+ *
+ * @param Mjd_TT Época TT correspondiente a t = 0 (Modified Julian Date).
+ */
+EclipseEvent::EclipseEvent(double Mjd_TT) : Mjd_TT(Mjd_TT) {}
+
+/**
+ * @brief Función de sombra: negativa dentro de la sombra cilíndrica de la Tierra [m].
+ */
+double EclipseEvent::g(double t, const double* Y) const {
+    double rb[11][3];
+    double *r_Mercury = rb[0], *r_Venus = rb[1], *r_Earth = rb[2], *r_Mars = rb[3], *r_Jupiter = rb[4],
+           *r_Saturn = rb[5], *r_Uranus = rb[6], *r_Neptune = rb[7], *r_Pluto = rb[8], *r_Moon = rb[9], *r_Sun = rb[10];
+    JPL_Eph_DE430(Mjday_TDB(Mjd_TT + t/86400.0), r_Mercury, r_Venus, r_Earth, r_Mars, r_Jupiter, r_Saturn,
+                  r_Uranus, r_Neptune, r_Pluto, r_Moon, r_Sun);
+
+    double ns = sqrt(r_Sun[0]*r_Sun[0] + r_Sun[1]*r_Sun[1] + r_Sun[2]*r_Sun[2]);
+    double rs = (Y[0]*r_Sun[0] + Y[1]*r_Sun[1] + Y[2]*r_Sun[2])/ns;
+    double r2 = Y[0]*Y[0] + Y[1]*Y[1] + Y[2]*Y[2];
+    if (rs >= 0.0) {
+        return sqrt(r2) - R_Earth;
+    }
+    return sqrt(fmax(r2 - rs*rs, 0.0)) - R_Earth;
+}
+
+/**
+ * @brief Detector de eventos para usar como observador de `RKInteg`.
+ *
+ * @param nsub Número de subintervalos en los que se muestrea cada paso.
+ * @param tol Tolerancia en el instante de los eventos [s].
+ */
+EventDetector::EventDetector(int nsub, double tol) : nsub(nsub), tol(tol) {}
+
+/**
+ * @brief Añade una función de evento (no se copia ni se libera).
+ *
+ * @return int Identificador del evento en los resultados.
+ */
+int EventDetector::addEvent(const EventFunction* f) {
+    functions.push_back(f);
+    return (int) functions.size() - 1;
+}
+
+/**
+ * @brief Olvida el paso anterior y los eventos encontrados.
+ */
+void EventDetector::clear() {
+    step.clear();
+    gold.clear();
+    events.clear();
+}
+
+/**
+ * @brief Nodo aceptado por el integrador: busca los eventos en el último paso.
+ *
+ * @param t Instante [s].
+ * @param Y Estado [r;v].
+ * @param dY Derivada [v;a].
+ */
+void EventDetector::operator()(double t, const double* Y, const double* dY) {
+    int nf = (int) functions.size();
+    if (step.getNodes() == 0) {
+        step.add(t, Y, dY);
+        for (int k = 0; k < nf; k++) {
+            gold.push_back(functions[k]->g(t, Y));
+        }
+        return;
+    }
+    step.add(t, Y, dY);
+    double t0 = step.getBegin();
+
+    double Yi[6];
+    for (int k = 0; k < nf; k++) {
+        double ta = t0, ga = gold[k];
+        for (int j = 1; j <= nsub; j++) {
+            double tb = t0 + (t - t0)*j/nsub;
+            double gb;
+            if (j == nsub) {
+                gb = functions[k]->g(t, Y);
+            } else {
+                step.eval(tb, Yi);
+                gb = functions[k]->g(tb, Yi);
+            }
+            if ((ga < 0.0 && gb >= 0.0) || (ga > 0.0 && gb <= 0.0)) {
+                //% Illinois regula falsi on [ta, tb]
+                double a = ta, b = tb, fa = ga, fb = gb, c = b;
+                int side = 0;
+                for (int it = 0; it < 100 && fabs(b - a) > tol; it++) {
+                    c = (a*fb - b*fa)/(fb - fa);
+                    step.eval(c, Yi);
+                    double fc = functions[k]->g(c, Yi);
+                    if (fc*fb > 0.0) {
+                        b = c; fb = fc;
+                        if (side == -1) fa *= 0.5;
+                        side = -1;
+                    } else if (fc*fa > 0.0) {
+                        a = c; fa = fc;
+                        if (side == 1) fb *= 0.5;
+                        side = 1;
+                    } else {
+                        break;
+                    }
+                }
+                Event ev = {c, k, gb > ga ? 1 : -1};
+                events.push_back(ev);
+            }
+            ta = tb;
+            ga = gb;
+        }
+        gold[k] = ga;
+    }
+
+    //% Keep only the last node for the next step
+    step.clear();
+    step.add(t, Y, dY);
+}
+
+/**
+ * @brief Eventos encontrados, en el orden en que se han detectado.
+ */
+const std::vector<Event>& EventDetector::getEvents() const {
+    return events;
+}
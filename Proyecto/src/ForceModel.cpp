@@ -0,0 +1,221 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "ForceModel.h"
+#include "AccelHarmonic.h"
+#include "AccelBatch.h"
+#include "AccelPointMass.h"
+#include "AccelDrag.h"
+#include "AccelSolrad.h"
+#include "GravityGrid.h"
+#include "Stats.h"
+#include "SAT_Const.h"
+
+/*%--------------------------------------------------------------------------
+%
+% ForceModel: Contributors to the acceleration of the satellite
+%
+% Every contributor adds its acceleration (ICRF/EME2000) to a shared
+% buffer from a ForceContext, which holds the epoch quantities computed
+% once by AccelEpoch (Earth orientation, frames, third bodies, Sun) and
+% the state of the satellite. Contributors switched off in AccelParam add
+% nothing. ForceContext::setState also keeps |r|, r.v and |v|^2, which
+% the harmonic term (degree selection) and the relativistic correction
+% share.
+%
+%   ForceSum<F...>   composition fixed at compile time; the calls to the
+%                    final contributor classes are resolved statically.
+%                    Timed with the PROYECTO_STATS timers.
+%   ForceRegistry    composition at run time, with the number of calls
+%                    and (optionally) the time spent in each contributor.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file ForceModel.cpp
+ * @brief Contribuyentes del modelo de fuerzas y su composición estática o dinámica.
+ */
+
+ForceContext::ForceContext() : p(nullptr), Mjd_TT(0.0), Mjd_UT1(0.0), T(3,3), E(3,3), d(0.0), rv(0.0), v2(0.0) {
+    for (int i = 0; i < 3; i++) {
+        r_Sun[i] = r_Moon[i] = r[i] = v[i] = 0.0;
+    }
+}
+
+/**
+ * @brief Fija el estado del satélite.
+ *
+ * @param Y Estado (posición y velocidad) en el sistema ICRF/EME2000.
+ */
+void ForceContext::setState(const double* Y) {
+    for (int i = 0; i < 3; i++) {
+        r[i] = Y[i];
+        v[i] = Y[i+3];
+    }
+    d = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+    rv = r[0]*v[0] + r[1]*v[1] + r[2]*v[2];
+    v2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+}
+
+/**
+ * @brief Campo gravitatorio armónico: tabla `GravityGrid` dentro de su capa, suma directa fuera
+ * (en precisión mixta si `p.mixed` está activo), con las mareas sólidas del contexto si están activas.
+ */
+void HarmonicForce::accumulate(ForceContext& c, double* a) const {
+    STAT_TIMER_START(TIMER_HARMONIC);
+    const GravityPatch* patch = c.p->tides ? &c.tide : nullptr;
+    double ah[3];
+    if (c.p->grid != nullptr && c.p->grid->accel(c.r, c.E, ah)) {
+        //% The table holds the static field: tides added separately
+        if (patch != nullptr) {
+            AccelPatch(c.r, c.E, *patch, ah);
+        }
+    } else if (c.p->mixed) {
+        int n, m;
+        GravityDegree(*c.p, c.d, n, m);
+        AccelHarmonicMixed(1, c.r, c.E, n, m, ah, patch);
+    } else {
+        int n, m;
+        GravityDegree(*c.p, c.d, n, m);
+        AccelHarmonic(c.r, c.E, n, m, ah, patch);
+    }
+    for (int i = 0; i < 3; i++) {
+        a[i] += ah[i];
+    }
+    STAT_TIMER_STOP(TIMER_HARMONIC);
+}
+
+/**
+ * @brief Perturbaciones del Sol, la Luna y los planetas.
+ */
+void ThirdBodyForce::accumulate(ForceContext& c, double* a) const {
+    STAT_TIMER_START(TIMER_POINTMASS);
+    AccelPointMass(c.bodies, 1, c.r, a);
+    STAT_TIMER_STOP(TIMER_POINTMASS);
+}
+
+/**
+ * @brief Resistencia atmosférica (si `p.density` no es nulo).
+ */
+void DragForce::accumulate(ForceContext& c, double* a) const {
+    if (c.p->density == nullptr) {
+        return;
+    }
+    STAT_TIMER_START(TIMER_DRAG);
+    AccelDrag(*c.p->density, c.Mjd_TT, c.r, c.v, c.r_Sun, c.T, c.p->area_drag, c.p->mass, c.p->CD, a);
+    STAT_TIMER_STOP(TIMER_DRAG);
+}
+
+/**
+ * @brief Presión de radiación solar (si `p.sRad` está activo).
+ */
+void SolradForce::accumulate(ForceContext& c, double* a) const {
+    if (!c.p->sRad) {
+        return;
+    }
+    STAT_TIMER_START(TIMER_SOLRAD);
+    double nu = Shadow(c.r, c.r_Sun, c.p->shadow, c.p->shadow_width);
+    AccelSolrad(c.r, c.r_Sun, c.p->area_solar, c.p->mass, c.p->CR, nu, a);
+    STAT_TIMER_STOP(TIMER_SOLRAD);
+}
+
+/**
+ * @brief Corrección relativista de Schwarzschild (si `p.relativity` está activo).
+ *
+ * a = GM/(c^2 r^3) ((4 GM/r - v^2) r + 4 (r.v) v), con r, r.v y v^2 del contexto.
+ */
+void RelativityForce::accumulate(ForceContext& c, double* a) const {
+    if (!c.p->relativity) {
+        return;
+    }
+    double k = GM_Earth/(c_light*c_light*c.d*c.d*c.d);
+    double kr = k*(4.0*GM_Earth/c.d - c.v2), kv = 4.0*k*c.rv;
+    for (int i = 0; i < 3; i++) {
+        a[i] += kr*c.r[i] + kv*c.v[i];
+    }
+}
+
+/**
+ * @brief Registro vacío de contribuyentes.
+ *
+ * @param timing Si es cierto, mide el tiempo de cada contribuyente (dos lecturas del reloj por llamada).
+ */
+ForceRegistry::ForceRegistry(bool timing) : timing(timing) {}
+
+/**
+ * @brief Añade un contribuyente.
+ *
+ * @param f Contribuyente (debe seguir existiendo mientras se use el registro).
+ * @return int Índice del contribuyente.
+ */
+int ForceRegistry::add(const ForceModel& f) {
+    std::unique_ptr<Entry> e(new Entry);
+    e->f = &f;
+    e->calls = 0;
+    e->ns = 0;
+    entries.push_back(std::move(e));
+    return (int) entries.size() - 1;
+}
+
+/**
+ * @brief Suma las aceleraciones de todos los contribuyentes en el orden en que se añadieron.
+ */
+void ForceRegistry::accumulate(ForceContext& c, double* a) const {
+    for (size_t i = 0; i < entries.size(); i++) {
+        Entry& e = *entries[i];
+        if (!timing) {
+            e.f->accumulate(c, a);
+        } else {
+            auto t0 = std::chrono::steady_clock::now();
+            e.f->accumulate(c, a);
+            auto t1 = std::chrono::steady_clock::now();
+            e.ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(),
+                           std::memory_order_relaxed);
+        }
+        e.calls.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int ForceRegistry::size() const {
+    return (int) entries.size();
+}
+
+const ForceModel& ForceRegistry::get(int i) const {
+    return *entries[i]->f;
+}
+
+/**
+ * @brief Número de llamadas al contribuyente i.
+ */
+unsigned long long ForceRegistry::getCalls(int i) const {
+    return entries[i]->calls.load();
+}
+
+/**
+ * @brief Tiempo acumulado en el contribuyente i [s] (0 sin medida de tiempos).
+ */
+double ForceRegistry::getSeconds(int i) const {
+    return 1e-9*entries[i]->ns.load();
+}
+
+void ForceRegistry::resetCounters() {
+    for (size_t i = 0; i < entries.size(); i++) {
+        entries[i]->calls = 0;
+        entries[i]->ns = 0;
+    }
+}
+
+/**
+ * @brief Imprime las llamadas y tiempos de cada contribuyente.
+ */
+void ForceRegistry::print() const {
+    printf("\nForce model contributors\n");
+    for (int i = 0; i < size(); i++) {
+        unsigned long long n = getCalls(i);
+        double sec = getSeconds(i);
+        printf("%-24s%14llu%12.3f [s]%10.3f [us/call]\n", get(i).name(), n, sec, n > 0 ? 1e6*sec/n : 0.0);
+    }
+}
@@ -44,7 +44,7 @@
 * @version 1.0
 * @date Fecha de creación
 */
-Matrix G_AccelHarmonic( double* r,Matrix U,int n_max,int m_max ){
+Matrix G_AccelHarmonic( double* r,const Matrix& U,int n_max,int m_max ){
 
     double d = 1.0;  // % Position increment [m]
     // Inicializar matriz G de ceros
@@ -64,14 +64,15 @@ Matrix G_AccelHarmonic( double* r,Matrix U,int n_max,int m_max ){
         for (int j = 0; j < 3; ++j) {
             r[j] = r[j] + dr[j];
         }
-        double* da1 = AccelHarmonic(r, U, n_max, m_max);
+        double da1[3], da2[3];
+        AccelHarmonic(r, U, n_max, m_max, da1);
         for (int j = 0; j < 3; ++j) {
             dr[j] = -dr[j]; // Invertir el vector de desplazamiento para calcular la otra diferencia de aceleración
         }
         for (int j = 0; j < 3; ++j) {
             aux[j] = aux[j] + dr[j];
         }
-        double* da2 = AccelHarmonic(aux, U, n_max, m_max);
+        AccelHarmonic(aux, U, n_max, m_max, da2);
 //% Derivative with respect to i-th axis
         for (int j = 0; j < 3; ++j) {
             G(j + 1, i + 1) = (da1[j] - da2[j]) / d;
@@ -0,0 +1,94 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "GravityTruncation.h"
+
+/*%--------------------------------------------------------------------------
+%
+% GravityTruncation: Altitude-adaptive degree of the harmonic gravity field
+%
+% With fully normalized coefficients, the mean square over a sphere of
+% radius d of the acceleration of the degree n terms is (Kaula)
+%
+%   <|a_n|^2> = (GM/d^2)^2 (R/d)^(2n) (n+1)(2n+1) sum_m (C_nm^2 + S_nm^2)
+%
+% The per-degree factors sqrt((n+1)(2n+1) sum_m (C_nm^2+S_nm^2)) are
+% precomputed once. For each evaluation the degree N is the smallest one
+% whose omitted terms N+1..n_max have a summed RMS acceleration below the
+% error budget tol. The error at a given point can exceed the RMS value
+% where the field is rough, so tol should keep a margin of a few.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file GravityTruncation.cpp
+ * @brief Grado del campo gravitatorio adaptado a la distancia al centro de la Tierra.
+ */
+
+static const double r_ref = 6378.1363e3;   // Earth's radius [m]; GGM03S
+static const double gm    = 398600.4415e9; // [m^3/s^2]; GGM03S
+
+/**
+ * @brief Precalcula la potencia de los coeficientes de cada grado.
+ *
+ * @param Cnm Coeficientes C normalizados (índices base 1, (n+1)x(n+1)).
+ * @param Snm Coeficientes S normalizados.
+ * @param tol Error de aceleración admisible por truncamiento [m/s^2].
+ */
+GravityTruncation::GravityTruncation(const Matrix& Cnm, const Matrix& Snm, double tol)
+    : power(Cnm.getRows()), tol(tol) {
+    for (int n = 0; n < Cnm.getRows(); n++) {
+        double s = 0.0;
+        for (int m = 0; m <= n; m++) {
+            s += Cnm(n+1,m+1)*Cnm(n+1,m+1) + Snm(n+1,m+1)*Snm(n+1,m+1);
+        }
+        power[n] = sqrt((n+1.0)*(2.0*n+1.0)*s);
+    }
+}
+
+/**
+ * @brief Grado de truncamiento para una distancia.
+ *
+ * @param d Distancia al centro de la Tierra [m].
+ * @param n_max Grado máximo del modelo.
+ * @return int Grado (entre 2 y n_max) cuyos términos omitidos suman como mucho tol.
+ */
+int GravityTruncation::degree(double d, int n_max) const {
+    if (n_max > (int) power.size() - 1) {
+        n_max = (int) power.size() - 1;
+    }
+    double q = r_ref/d;
+    double g = gm/(d*d)*pow(q, n_max);
+    double sum = 0.0;
+    for (int n = n_max; n > 2; n--) {
+        sum += g*power[n];
+        if (sum > tol) {
+            return n;
+        }
+        g /= q;
+    }
+    return n_max < 2 ? n_max : 2;
+}
+
+/**
+ * @brief Aceleración RMS de los grados n+1..n_max a una distancia [m/s^2].
+ */
+double GravityTruncation::tail(double d, int n, int n_max) const {
+    if (n_max > (int) power.size() - 1) {
+        n_max = (int) power.size() - 1;
+    }
+    double q = r_ref/d;
+    double sum = 0.0;
+    for (int k = n+1; k <= n_max; k++) {
+        sum += gm/(d*d)*pow(q, k)*power[k];
+    }
+    return sum;
+}
+
+/**
+ * @brief Error de aceleración admisible [m/s^2].
+ */
+double GravityTruncation::getTol() const {
+    return tol;
+}
@@ -61,7 +61,6 @@ void IERS(Matrix eop, double Mjd_UTC, char interp,
             nexteop(1, row) = eop(row, mjd+1);
         }
 
-        preeop.print();
     double mfme = 1440 * (Mjd_UTC - floor(Mjd_UTC));
     double fixf = mfme / 1440;
     /*% Setting
@@ -71,7 +70,6 @@ void IERS(Matrix eop, double Mjd_UTC, char interp,
     rotation
     parameters
     % (UT1 - UTC[s], TAI - UTC[s], x["], y ["])*/
-    preeop.print();
         x_pole = preeop(1, 5) + (nexteop(1, 5) - preeop(1, 5)) * fixf;
         y_pole = preeop(1, 6) + (nexteop(1, 6) - preeop(1, 6)) * fixf;
         UT1_UTC = preeop(1, 7) + (nexteop(1, 7) - preeop(1, 7)) * fixf;
@@ -93,7 +93,7 @@ Matrix Matrix::operator-(const Matrix& matrix2)
  
 Matrix Matrix::operator*(const Matrix& matrix2)
 {
-    Matrix result(fil, col);
+    Matrix result(fil, matrix2.col);
  
     for (int i = 0; i < this->fil ; i++){
         for (int j = 0; j < matrix2.col; j++){
@@ -175,8 +175,8 @@ Matrix Matrix::inverse() const{
         double maxVal = temp.matrix[i][i];
         int maxRow = i;
         for (int j = i + 1; j < fil; ++j) {
-            if (std::abs(temp(j, i)) > std::abs(maxVal)) {
-                maxVal = temp(j, i);
+            if (std::abs(temp.matrix[j][i]) > std::abs(maxVal)) {
+                maxVal = temp.matrix[j][i];
                 maxRow = j;
             }
         }
@@ -258,7 +258,7 @@ Matrix Matrix::concatenateHorizontal(Matrix A, Matrix B) {
     return result;
 }
 double* Matrix::multiply(Matrix E, const double* r, int size) {
-    auto* result = new double[E.getRows()];
+    auto* result = new double[E.getRows()]();
     for (int i = 0; i < E.getRows(); ++i) {
         for (int j = 0; j < E.getCol(); ++j) {
             result[i] += E(i + 1, j + 1) * r[j];
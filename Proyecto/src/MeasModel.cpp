@@ -0,0 +1,129 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include "MeasModel.h"
+#include "Matrix.h"
+#include "Position.h"
+#include "LTC.h"
+#include "AzElPa.h"
+#include "norm.h"
+
+/*%--------------------------------------------------------------------------
+%
+% MeasModel: Observation model of a network of ground stations measuring
+%            azimuth, elevation and range of an Earth orbiting satellite
+%
+% The body-fixed position and the local tangent coordinates matrix of every
+% station are computed once, when the station is added. The topocentric
+% position s = LT*(U*r-Rs) is computed once per epoch and shared by the
+% three measurement types and their partials.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file MeasModel.cpp
+ * @brief Modelo de observación de una red de estaciones terrenas (azimut, elevación y distancia).
+ */
+
+/**
+ * @brief Añade una estación a la red.
+ *
+ * Calcula una única vez la posición de la estación en el sistema fijo a la Tierra (`Position`)
+ * y la matriz de coordenadas locales tangentes (`LTC`).
+ *
+ * @param lon Longitud geodésica [rad].
+ * @param lat Latitud geodésica [rad].
+ * @param alt Altitud [m].
+ * @param sigma_az Desviación típica del azimut [rad].
+ * @param sigma_el Desviación típica de la elevación [rad].
+ * @param sigma_range Desviación típica de la distancia [m].
+ * @return int Índice de la estación (empezando en 0).
+ */
+int MeasModel::addStation(double lon, double lat, double alt,
+                          double sigma_az, double sigma_el, double sigma_range){
+    Station st;
+    st.lon = lon;
+    st.lat = lat;
+    st.alt = alt;
+
+    double* Rs = Position(lon, lat, alt);
+    Matrix LT = LTC(lon, lat);
+    for (int i = 0; i < 3; i++) {
+        st.Rs[i] = Rs[i];
+        for (int j = 0; j < 3; j++) {
+            st.LT[i][j] = LT(i+1, j+1);
+        }
+    }
+    delete[] Rs;
+
+    st.sigma[MEAS_AZIMUTH] = sigma_az;
+    st.sigma[MEAS_ELEVATION] = sigma_el;
+    st.sigma[MEAS_RANGE] = sigma_range;
+
+    stations.push_back(st);
+    return (int) stations.size() - 1;
+}
+
+/**
+ * @brief Número de estaciones de la red.
+ */
+int MeasModel::getStations() const {
+    return (int) stations.size();
+}
+
+/**
+ * @brief Devuelve la estación k-ésima.
+ */
+const Station& MeasModel::getStation(int k) const {
+    return stations[k];
+}
+
+/**
+ * @brief Calcula azimut, elevación, distancia y sus derivadas parciales para una estación.
+ *
+ * @param k Índice de la estación.
+ * @param U Matriz de rotación de la Tierra (inercial a fijo a la Tierra).
+ * @param r Posición del satélite en el sistema inercial [m].
+ * @param pred Predicción (salida): posición topocéntrica, valores y derivadas respecto al estado.
+ *
+ * @details
+ * La posición topocéntrica s = LT*(U*r-Rs) se calcula una sola vez y la matriz
+ * ds/dr = LT*U se reutiliza para las derivadas de los tres tipos de medida.
+ * Las derivadas respecto a la velocidad son nulas.
+ */
+void MeasModel::predict(int k, Matrix& U, const double* r, MeasPrediction& pred) const {
+    const Station& st = stations[k];
+
+    //% Topocentric position and its partials w.r.t. the inertial position
+    double d[3];
+    for (int i = 0; i < 3; i++) {
+        d[i] = U(i+1,1)*r[0] + U(i+1,2)*r[1] + U(i+1,3)*r[2] - st.Rs[i];
+    }
+    double dsdr[3][3];
+    for (int i = 0; i < 3; i++) {
+        pred.s[i] = st.LT[i][0]*d[0] + st.LT[i][1]*d[1] + st.LT[i][2]*d[2];
+        for (int j = 0; j < 3; j++) {
+            dsdr[i][j] = st.LT[i][0]*U(1,j+1) + st.LT[i][1]*U(2,j+1) + st.LT[i][2]*U(3,j+1);
+        }
+    }
+
+    //% Azimuth, elevation and partials
+    double dAds[3], dEds[3];
+    double* pA = dAds;
+    double* pE = dEds;
+    AzElPa(pred.s, pA, pE, pred.value[MEAS_AZIMUTH], pred.value[MEAS_ELEVATION]);
+
+    //% Range and partials
+    double Dist = norm(pred.s, 3);
+    double dDds[3] = {pred.s[0]/Dist, pred.s[1]/Dist, pred.s[2]/Dist};
+    pred.value[MEAS_RANGE] = Dist;
+
+    for (int j = 0; j < 3; j++) {
+        pred.dzdY[MEAS_AZIMUTH][j] = dAds[0]*dsdr[0][j] + dAds[1]*dsdr[1][j] + dAds[2]*dsdr[2][j];
+        pred.dzdY[MEAS_ELEVATION][j] = dEds[0]*dsdr[0][j] + dEds[1]*dsdr[1][j] + dEds[2]*dsdr[2][j];
+        pred.dzdY[MEAS_RANGE][j] = dDds[0]*dsdr[0][j] + dDds[1]*dsdr[1][j] + dDds[2]*dsdr[2][j];
+        pred.dzdY[MEAS_AZIMUTH][j+3] = 0.0;
+        pred.dzdY[MEAS_ELEVATION][j+3] = 0.0;
+        pred.dzdY[MEAS_RANGE][j+3] = 0.0;
+    }
+}
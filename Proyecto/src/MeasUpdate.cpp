@@ -31,7 +31,7 @@ void MeasUpdate(Matrix& x,Matrix z,Matrix g,Matrix s,Matrix G,Matrix& P,int n,Ma
 
     // State update
     Matrix u = (z - g);
-    Matrix v = u*K ;
+    Matrix v = u*K.transpose();
     x =  x + v ;
     Matrix p = Matrix::identity(n);
     // Covariance update
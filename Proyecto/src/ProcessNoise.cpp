@@ -0,0 +1,188 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <stdexcept>
+#include "ProcessNoise.h"
+#include "Matrix.h"
+
+/*%--------------------------------------------------------------------------
+%
+% ProcessNoise: Analytically integrated process noise covariance matrices
+%
+%   SNC  State noise compensation: white acceleration noise of spectral
+%        density q [m^2/s^3] on each inertial axis.
+%   DMC  Dynamic model compensation: first-order Gauss-Markov acceleration
+%        w' = -w/tau + u, u white noise of spectral density q, appended to
+%        the state as (r,v,w).
+%
+% NoiseMatrix gives the (r,v) covariance of SNC. With DMC the filter
+% carries w in its state: DMCTimeUpdate propagates the augmented state and
+% covariance with the closed-form transition of w (DMCTransition) and the
+% 9x9 noise matrix.
+%
+% Both are evaluated in closed form for the whole interval, so long gaps
+% between passes need no subdivision of the propagation.
+%
+% Reference:
+%   B.D. Tapley, B.E. Schutz, G.H. Born, "Statistical Orbit Determination",
+%   Elsevier Academic Press, 2004; Section 4.9.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file ProcessNoise.cpp
+ * @brief Matrices de ruido del proceso (SNC y DMC) integradas analíticamente.
+ */
+
+/**
+ * @brief Ruido del proceso por compensación de ruido de estado (SNC).
+ *
+ * Q = q*[ |dt|^3/3*I  dt*|dt|/2*I ; dt*|dt|/2*I  |dt|*I ]
+ *
+ * @param dt Intervalo de propagación [s] (puede ser negativo).
+ * @param q Densidad espectral de la aceleración no modelada [m^2/s^3].
+ * @return Matrix Matriz 6x6 de ruido del proceso.
+ */
+Matrix SNCNoise(double dt, double q){
+    Matrix Q(6,6);
+    double adt = fabs(dt);
+
+    for (int i = 1; i <= 3; i++) {
+        Q(i,i) = q*adt*adt*adt/3.0;
+        Q(i,i+3) = q*dt*adt/2.0;
+        Q(i+3,i) = Q(i,i+3);
+        Q(i+3,i+3) = q*adt;
+    }
+    return Q;
+}
+
+/**
+ * @brief Ruido del proceso por compensación dinámica del modelo (DMC).
+ *
+ * @param dt Intervalo de propagación [s] (dt >= 0).
+ * @param tau Tiempo de correlación del proceso de Gauss-Markov [s].
+ * @param q Densidad espectral del ruido blanco que excita el proceso [m^2/s^5].
+ * @return Matrix Matriz 9x9 de ruido del proceso para el estado (r,v,w). El bloque 6x6
+ * superior es la contribución a (r,v) cuando las aceleraciones w no se estiman.
+ *
+ * @details
+ * Para beta*dt pequeño (beta = 1/tau) las expresiones cerradas pierden precisión por
+ * cancelación y se sustituyen por su desarrollo en serie hasta primer orden en beta*dt.
+ */
+Matrix DMCNoise(double dt, double tau, double q){
+    Matrix Q(9,9);
+    double b = 1.0/tau;
+    double x = b*dt;
+    double Qrr, Qrv, Qrw, Qvv, Qvw, Qww;
+
+    Qww = -q*expm1(-2.0*x)/(2.0*b);
+    if (x < 1e-2) {
+        double dt2 = dt*dt, dt3 = dt2*dt;
+        Qrr = q*dt3*dt2*(1.0/20.0 - x/36.0);
+        Qrv = q*dt3*dt*(1.0/8.0 - x/12.0);
+        Qrw = q*dt3*(1.0/6.0 - x/6.0);
+        Qvv = q*dt3*(1.0/3.0 - x/4.0);
+        Qvw = q*dt2*(1.0/2.0 - x/2.0);
+    } else {
+        double e1 = exp(-x), e2 = exp(-2.0*x);
+        double b2 = b*b, b3 = b2*b, b4 = b3*b, b5 = b4*b;
+        Qrr = q*(dt*dt*dt/(3.0*b2) - dt*dt/b3 + dt/b4*(1.0-2.0*e1) + (1.0-e2)/(2.0*b5));
+        Qrv = q*(dt*dt/(2.0*b2) - dt/b3*(1.0-e1) + (1.0-e1)/b4 - (1.0-e2)/(2.0*b4));
+        Qrw = q*((1.0-e2)/(2.0*b3) - dt/b2*e1);
+        Qvv = q*(dt/b2 - 2.0/b3*(1.0-e1) + (1.0-e2)/(2.0*b3));
+        Qvw = q*((1.0+e2)/(2.0*b2) - e1/b2);
+    }
+
+    for (int i = 1; i <= 3; i++) {
+        Q(i,i) = Qrr;
+        Q(i,i+3) = Qrv;   Q(i+3,i) = Qrv;
+        Q(i,i+6) = Qrw;   Q(i+6,i) = Qrw;
+        Q(i+3,i+3) = Qvv;
+        Q(i+3,i+6) = Qvw; Q(i+6,i+3) = Qvw;
+        Q(i+6,i+6) = Qww;
+    }
+    return Q;
+}
+
+/**
+ * @brief Bloques de la matriz de transición del estado aumentado (r,v,w) debidos a DMC.
+ *
+ * @param dt Intervalo de propagación [s].
+ * @param tau Tiempo de correlación [s].
+ * @return Matrix Matriz 9x9 con dr/dw, dv/dw y dw/dw; el bloque (r,v) es la identidad y
+ * debe sustituirse por la matriz de transición de la dinámica.
+ */
+Matrix DMCTransition(double dt, double tau){
+    Matrix Phi = Matrix::identity(9);
+    double b = 1.0/tau;
+    double e1 = exp(-b*dt);
+    double em1 = -expm1(-b*dt);    // 1-exp(-b*dt)
+    double Phi_rw;
+    if (b*dt < 1e-2) {
+        Phi_rw = dt*dt*(0.5 - b*dt/6.0);
+    } else {
+        Phi_rw = (b*dt - em1)/(b*b);
+    }
+
+    for (int i = 1; i <= 3; i++) {
+        Phi(i,i+6) = Phi_rw;
+        Phi(i+3,i+6) = em1/b;
+        Phi(i+6,i+6) = e1;
+    }
+    return Phi;
+}
+
+/**
+ * @brief Ruido del proceso del estado (r,v) para el modelo elegido.
+ *
+ * @param noise Modelo y parámetros del ruido (ninguno o SNC).
+ * @param dt Intervalo de propagación [s] (puede ser negativo).
+ * @return Matrix Matriz 6x6 de ruido del proceso.
+ * @throws std::invalid_argument Con DMC, cuyo ruido es el del estado aumentado (`DMCTimeUpdate`).
+ */
+Matrix NoiseMatrix(const NoiseParam& noise, double dt){
+    Matrix Q(6,6);
+    if (noise.model == NOISE_SNC) {
+        Q = SNCNoise(dt, noise.q);
+    } else if (noise.model == NOISE_DMC) {
+        throw std::invalid_argument("NoiseMatrix: DMC needs the augmented state (DMCTimeUpdate)");
+    }
+    return Q;
+}
+
+/**
+ * @brief Actualización temporal del estado aumentado (r,v,w) con compensación dinámica del modelo.
+ *
+ * La posición y la velocidad se propagan antes con la dinámica sin w; aquí se les suma el
+ * efecto lineal de w durante el intervalo (bloques dr/dw y dv/dw de `DMCTransition`), w decae
+ * con exp(-dt/tau) y P = Phi9*P*Phi9' + `DMCNoise`.
+ *
+ * @param Y Estado (r,v,w) (entrada y salida, 9): (r,v) propagados con la dinámica, w en la época anterior.
+ * @param P Covarianza 9x9 (entrada y salida).
+ * @param Phi Matriz de transición 6x6 de la dinámica en el intervalo.
+ * @param dt Intervalo de propagación [s] (dt >= 0).
+ * @param tau Tiempo de correlación [s].
+ * @param q Densidad espectral del ruido blanco que excita el proceso [m^2/s^5].
+ * @return Matrix Matriz de transición 9x9 del estado aumentado.
+ * @throws std::invalid_argument Si dt < 0.
+ */
+Matrix DMCTimeUpdate(double* Y, Matrix& P, const Matrix& Phi, double dt, double tau, double q){
+    if (dt < 0.0) {
+        throw std::invalid_argument("DMCTimeUpdate: negative interval");
+    }
+    Matrix Phi9 = DMCTransition(dt, tau);
+    for (int i = 1; i <= 6; i++) {
+        for (int j = 1; j <= 6; j++) {
+            Phi9(i,j) = Phi(i,j);
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        Y[i] += Phi9(i+1,i+7)*Y[i+6];
+        Y[i+3] += Phi9(i+4,i+7)*Y[i+6];
+        Y[i+6] *= Phi9(i+7,i+7);
+    }
+    P = Phi9 * P * Phi9.transpose() + DMCNoise(dt, tau, q);
+    return Phi9;
+}
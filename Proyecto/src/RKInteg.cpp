@@ -0,0 +1,99 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <memory>
+#include "RKInteg.h"
+
+/*%----------------------------------------------------------------------------
+%
+% Purpose:
+%   Numerical integration of ordinary differential equations with the
+%   explicit embedded Runge-Kutta method of order 8(5,3) of Dormand & Prince
+%   (DOP853)
+%
+%   Twelve stages per step; the derivative at the end of an accepted step is
+%   the first stage of the next one (FSAL), so every accepted step costs
+%   twelve function evaluations. The step size is controlled with the
+%   combined 5th and 3rd order error estimators of Hairer & Wanner.
+%
+% Reference:
+%
+%   Hairer, Norsett, Wanner: "Solving Ordinary Differential Equations I.
+%   Nonstiff Problems", Springer (1993), Section II.10.
+%
+%----------------------------------------------------------------------------*/
+/**
+ * @file RKInteg.cpp
+ * @brief Integrador Runge-Kutta embebido de orden 8(5,3) (DOP853) con control de paso.
+ */
+
+void RKWork::resize(int n_eqn) {
+    if (n == n_eqn) {
+        return;
+    }
+    n = n_eqn;
+    buf.assign(12*n, 0.0);
+    double* p = buf.data();
+    k1 = p; k2 = p+n; k3 = p+2*n; k4 = p+3*n; k5 = p+4*n; k6 = p+5*n;
+    k7 = p+6*n; k8 = p+7*n; k9 = p+8*n; k10 = p+9*n; y1 = p+10*n; yt = p+11*n;
+}
+
+/**
+ * @brief Pila de buffers del hilo actual, uno por nivel de anidamiento.
+ */
+struct RKStack {
+    std::vector<std::unique_ptr<RKWork>> work;
+    int depth = 0;
+};
+
+static RKStack& ThreadRKStack() {
+    static thread_local RKStack s;
+    return s;
+}
+
+static RKWork& AcquireRKWork(int n_eqn) {
+    RKStack& s = ThreadRKStack();
+    if (s.depth == (int) s.work.size()) {
+        s.work.emplace_back(new RKWork());
+    }
+    RKWork& w = *s.work[s.depth++];
+    w.resize(n_eqn);
+    return w;
+}
+
+/**
+ * @brief Toma los buffers del siguiente nivel de anidamiento, dimensionados para n_eqn ecuaciones.
+ */
+RKWorkScope::RKWorkScope(int n_eqn) : w(AcquireRKWork(n_eqn)) {
+}
+
+/**
+ * @brief Devuelve los buffers a la pila (también si la integración lanza una excepción).
+ */
+RKWorkScope::~RKWorkScope() {
+    ThreadRKStack().depth--;
+}
+
+/**
+ * @brief Versión de `RKInteg` para funciones que devuelven la derivada en memoria nueva.
+ *
+ * @param func Función que devuelve la derivada dy/dt (memoria reservada con new[]).
+ * @param t Instante inicial.
+ * @param tout Instante final.
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @param n_eqn Número de ecuaciones.
+ * @param y Estado en t (entrada) y en tout (salida).
+ * @return double* Puntero a y.
+ */
+double* RKInteg(double* (*func)(double,double *),double t,double tout,double relerr,double abserr,int n_eqn,double* y) {
+    auto f = [func, n_eqn](double x, const double* yx, double* dy) {
+        double* d = func(x, const_cast<double*>(yx));
+        for (int i = 0; i < n_eqn; i++) {
+            dy[i] = d[i];
+        }
+        delete[] d;
+    };
+    return RKInteg(f,t,tout,relerr,abserr,n_eqn,y);
+}
@@ -0,0 +1,309 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <stdexcept>
+#include "RTSSmoother.h"
+#include "Matrix.h"
+
+/*%--------------------------------------------------------------------------
+%
+% RTSSmoother: Rauch-Tung-Striebel fixed-interval smoother
+%
+% The forward filter stores one checkpoint per epoch in a contiguous arena:
+%
+%   Mjd_UTC | Y_pred(n) | P_pred(n(n+1)/2) | Phi(n^2) | Y_filt(n) | P_filt(n(n+1)/2)
+%
+% with n = 6 for (r,v), or 9 when the filter estimates the Gauss-Markov
+% accelerations of dynamic model compensation (r,v,w).
+% Covariances are packed (upper triangle, row-wise) and Phi=Phi(t_k,t_k-1)
+% is stored row-wise. The backward sweep overwrites Y_filt and P_filt with
+% the smoothed state and covariance:
+%
+%   C_k  = P_filt(k)*Phi(k+1)'*inv(P_pred(k+1))
+%   Y(k) = Y_filt(k) + C_k*(Y(k+1)-Y_pred(k+1))
+%   P(k) = P_filt(k) + C_k*(P(k+1)-P_pred(k+1))*C_k'
+%
+% Reference:
+%   H.E. Rauch, F. Tung, C.T. Striebel, "Maximum likelihood estimates of
+%   linear dynamic systems", AIAA Journal 3(8), 1965.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file RTSSmoother.cpp
+ * @brief Suavizador de Rauch-Tung-Striebel sobre los resultados del filtro de Kalman extendido.
+ */
+
+/**
+ * @brief Índice de un elemento (i,j) de una matriz simétrica nxn empaquetada.
+ */
+static int packed(int n, int i, int j){
+    if (i > j) {
+        int aux = i; i = j; j = aux;
+    }
+    return n*i - i*(i-1)/2 + (j-i);
+}
+
+static void pack(int n, Matrix& P, double* Pp){
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            Pp[packed(n,i,j)] = P(i+1,j+1);
+        }
+    }
+}
+
+typedef double Block[RTSSmoother::NMAX][RTSSmoother::NMAX];
+
+static void unpack(int n, const double* Pp, Block P){
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            P[i][j] = Pp[packed(n,i,j)];
+        }
+    }
+}
+
+/**
+ * @brief Resuelve A*X = B (A simétrica definida positiva nxn) mediante Cholesky.
+ *
+ * @return false si A no es definida positiva.
+ */
+static bool CholSolve(int n, Block A, Block B){
+    Block L;
+    for (int j = 0; j < n; j++) {
+        double d = A[j][j];
+        for (int k = 0; k < j; k++) {
+            d -= L[j][k]*L[j][k];
+        }
+        if (d <= 0.0) {
+            return false;
+        }
+        L[j][j] = sqrt(d);
+        for (int i = j+1; i < n; i++) {
+            double s = A[i][j];
+            for (int k = 0; k < j; k++) {
+                s -= L[i][k]*L[j][k];
+            }
+            L[i][j] = s/L[j][j];
+        }
+    }
+    for (int c = 0; c < n; c++) {
+        //% Forward substitution L*y = b
+        for (int i = 0; i < n; i++) {
+            double s = B[i][c];
+            for (int k = 0; k < i; k++) {
+                s -= L[i][k]*B[k][c];
+            }
+            B[i][c] = s/L[i][i];
+        }
+        //% Back substitution L'*x = y
+        for (int i = n-1; i >= 0; i--) {
+            double s = B[i][c];
+            for (int k = i+1; k < n; k++) {
+                s -= L[k][i]*B[k][c];
+            }
+            B[i][c] = s/L[i][i];
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Crea un suavizador con memoria reservada para un número de épocas.
+ *
+ * @param capacity Número de épocas previsto. Mientras no se supere, no se reserva memoria por época.
+ * @param nstate Dimensión del estado (6: posición y velocidad; 9: con las aceleraciones de DMC).
+ * @throws std::invalid_argument Si nstate no está entre 1 y NMAX.
+ */
+RTSSmoother::RTSSmoother(int capacity, int nstate) : nepoch(0), n(nstate) {
+    if (n < 1 || n > NMAX) {
+        throw std::invalid_argument("RTSSmoother: unsupported state dimension");
+    }
+    int np = n*(n+1)/2;
+    off_yp = 1;
+    off_pp = off_yp + n;
+    off_phi = off_pp + np;
+    off_yf = off_phi + n*n;
+    off_pf = off_yf + n;
+    rec_size = off_pf + np;
+    arena.reserve(rec_size*capacity);
+}
+
+/**
+ * @brief Guarda la parte de predicción del punto de control de una nueva época.
+ *
+ * @param Mjd_UTC Fecha Juliana Modificada (UTC) de la época.
+ * @param Y_pred Estado propagado (antes de la actualización de medida).
+ * @param P_pred Covarianza propagada.
+ * @param Phi Matriz de transición desde la época anterior.
+ */
+void RTSSmoother::storePrediction(double Mjd_UTC, const double* Y_pred, Matrix& P_pred, Matrix& Phi){
+    arena.resize(rec_size*(nepoch+1));
+    double* rec = &arena[rec_size*nepoch];
+
+    rec[0] = Mjd_UTC;
+    for (int i = 0; i < n; i++) {
+        rec[off_yp+i] = Y_pred[i];
+        rec[off_yf+i] = Y_pred[i];
+        for (int j = 0; j < n; j++) {
+            rec[off_phi+n*i+j] = Phi(i+1,j+1);
+        }
+    }
+    pack(n, P_pred, rec+off_pp);
+    pack(n, P_pred, rec+off_pf);
+    nepoch++;
+}
+
+/**
+ * @brief Guarda el estado y la covarianza filtrados de la última época.
+ *
+ * @param Y_filt Estado filtrado.
+ * @param P_filt Covarianza filtrada.
+ */
+void RTSSmoother::storeUpdate(const double* Y_filt, Matrix& P_filt){
+    double* rec = &arena[rec_size*(nepoch-1)];
+
+    for (int i = 0; i < n; i++) {
+        rec[off_yf+i] = Y_filt[i];
+    }
+    pack(n, P_filt, rec+off_pf);
+}
+
+/**
+ * @brief Recorrido hacia atrás del suavizador RTS.
+ *
+ * Sustituye en el propio almacén el estado y la covarianza filtrados por los suavizados.
+ * No reserva memoria dinámica.
+ */
+void RTSSmoother::smooth(){
+    Block Pf, Pp, Ps, B, C, D;
+
+    for (int k = nepoch-2; k >= 0; k--) {
+        double* rec = &arena[rec_size*k];
+        double* next = &arena[rec_size*(k+1)];
+        const double* Phi = next+off_phi;
+
+        unpack(n, rec+off_pf, Pf);
+        unpack(n, next+off_pp, Pp);
+        unpack(n, next+off_pf, Ps);
+
+        //% Smoother gain C' = inv(P_pred)*Phi*P_filt
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                double s = 0.0;
+                for (int l = 0; l < n; l++) {
+                    s += Phi[n*i+l]*Pf[l][j];
+                }
+                B[i][j] = s;
+            }
+        }
+        if (!CholSolve(n, Pp, B)) {
+            //% Not positive definite (round-off): general inverse
+            Matrix Pm(n,n);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    Pm(i+1,j+1) = Pp[i][j];
+                }
+            }
+            Matrix Inv = Pm.inverse();
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    double s = 0.0;
+                    for (int l = 0; l < n; l++) {
+                        s += Inv(i+1,l+1)*B[l][j];
+                    }
+                    D[i][j] = s;
+                }
+            }
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    B[i][j] = D[i][j];
+                }
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                C[i][j] = B[j][i];
+            }
+        }
+
+        //% Smoothed state
+        double dY[NMAX];
+        for (int i = 0; i < n; i++) {
+            dY[i] = next[off_yf+i] - next[off_yp+i];
+        }
+        for (int i = 0; i < n; i++) {
+            double s = 0.0;
+            for (int j = 0; j < n; j++) {
+                s += C[i][j]*dY[j];
+            }
+            rec[off_yf+i] += s;
+        }
+
+        //% Smoothed covariance
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                Ps[i][j] -= Pp[i][j];
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                double s = 0.0;
+                for (int l = 0; l < n; l++) {
+                    s += C[i][l]*Ps[l][j];
+                }
+                D[i][j] = s;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = i; j < n; j++) {
+                double s = 0.0;
+                for (int l = 0; l < n; l++) {
+                    s += D[i][l]*C[j][l];
+                }
+                rec[off_pf+packed(n,i,j)] = Pf[i][j] + s;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Número de épocas almacenadas.
+ */
+int RTSSmoother::getEpochs() const {
+    return nepoch;
+}
+
+/**
+ * @brief Dimensión del estado.
+ */
+int RTSSmoother::getStates() const {
+    return n;
+}
+
+/**
+ * @brief Fecha Juliana Modificada (UTC) de la época k.
+ */
+double RTSSmoother::getMjd(int k) const {
+    return arena[rec_size*k];
+}
+
+/**
+ * @brief Estado de la época k (filtrado, o suavizado tras `smooth`).
+ */
+void RTSSmoother::getState(int k, double* Y) const {
+    for (int i = 0; i < n; i++) {
+        Y[i] = arena[rec_size*k+off_yf+i];
+    }
+}
+
+/**
+ * @brief Covarianza nxn de la época k (filtrada, o suavizada tras `smooth`).
+ */
+void RTSSmoother::getCovariance(int k, Matrix& P) const {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            P(i+1,j+1) = arena[rec_size*k+off_pf+packed(n,i,j)];
+        }
+    }
+}
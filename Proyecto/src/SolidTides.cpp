@@ -0,0 +1,161 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include "SolidTides.h"
+#include "Matrix.h"
+#include "Legendre.h"
+#include "SAT_Const.h"
+#include "global.h"
+#include "AccelBatch.h"
+
+/*%--------------------------------------------------------------------------
+%
+% SolidTides: Solid Earth tide corrections to the geopotential coefficients
+%
+% Step 1 of the IERS Conventions (frequency independent Love numbers,
+% anelastic Earth), for the Sun and the Moon (j):
+%
+%   dC_nm - i dS_nm = k_nm/(2n+1) sum_j GM_j/GM (R/r_j)^(n+1) P_nm(sin phi_j) exp(-i m lon_j)
+%                                                              n = 2, 3
+%   dC_4m - i dS_4m = k+_2m/5     sum_j GM_j/GM (R/r_j)^3     P_2m(sin phi_j) exp(-i m lon_j)
+%                                                              m = 0, 1, 2
+%
+% with fully normalized P_nm and the body-fixed positions of the bodies.
+% The frequency dependent corrections (step 2) and the permanent tide
+% are not applied.
+%
+% The corrections change with the epoch only, so they are evaluated once
+% per epoch and added to a GravityPatch: a copy of the degree 0..4 block
+% of Cnm/Snm that lives with the caller (one per evaluation context, hence
+% per thread), while the shared tables are never written. A TideCache
+% evaluates the corrections on a fixed grid of UTC epochs and interpolates
+% them linearly in between: the stages of an integration step share the
+% same two nodes, the force stays continuous in time, and the result does
+% not depend on which thread or in which order the epochs were visited.
+%
+% Reference:
+%   G. Petit, B. Luzum (eds.), "IERS Conventions (2010)", IERS Technical
+%   Note 36, 2010; Section 6.2.1.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file SolidTides.cpp
+ * @brief Correcciones de marea terrestre sólida a los coeficientes del campo gravitatorio.
+ */
+
+//% Nominal Love numbers, anelastic Earth (IERS Conventions 2010, Table 6.3)
+static const double k_re[4][4] = {
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.30190, 0.29830, 0.30102, 0.0},
+    {0.093, 0.093, 0.093, 0.094}};
+static const double k_im[4][4] = {
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, -0.00144, -0.00130, 0.0},
+    {0.0, 0.0, 0.0, 0.0}};
+static const double k_plus[3] = {-0.00089, -0.00080, -0.00057};
+
+/**
+ * @brief Bloque sin corregir (n = -1).
+ */
+GravityPatch::GravityPatch() : n(-1) {
+    for (int i = 0; i <= NMAX; i++) {
+        for (int j = 0; j <= NMAX; j++) {
+            C[i][j] = 0.0;
+            S[i][j] = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Copia el bloque de grado 0..4 de `global::Cnm`/`global::Snm` y le suma las correcciones.
+ *
+ * @param dC Correcciones de C (índices base 0).
+ * @param dS Correcciones de S (índices base 0).
+ */
+void GravityPatch::set(const double dC[NMAX+1][NMAX+1], const double dS[NMAX+1][NMAX+1]) {
+    Matrix& Cnm = *global::Cnm;
+    Matrix& Snm = *global::Snm;
+    n = NMAX < Cnm.getRows() - 1 ? NMAX : Cnm.getRows() - 1;
+    for (int i = 0; i <= n; i++) {
+        for (int j = 0; j <= i; j++) {
+            C[i][j] = Cnm(i+1,j+1) + dC[i][j];
+            S[i][j] = Snm(i+1,j+1) + dS[i][j];
+        }
+    }
+}
+
+/**
+ * @brief Caché vacía.
+ */
+TideCache::TideCache() : step(0.0), evaluations(0) {
+    k[0] = -1;
+    k[1] = -1;
+}
+
+/**
+ * @brief Correcciones de marea sólida de los coeficientes de grado 2 a 4.
+ *
+ * @param r_Sun_bf Posición del Sol en el sistema ligado a la Tierra [m].
+ * @param r_Moon_bf Posición de la Luna en el sistema ligado a la Tierra [m].
+ * @param dC Correcciones de C normalizados (salida, índices base 0 [n][m]).
+ * @param dS Correcciones de S normalizados (salida).
+ */
+void SolidTides(const double* r_Sun_bf, const double* r_Moon_bf, double dC[5][5], double dS[5][5]){
+    for (int n = 0; n <= 4; n++) {
+        for (int m = 0; m <= 4; m++) {
+            dC[n][m] = 0.0;
+            dS[n][m] = 0.0;
+        }
+    }
+
+    const double* rb[2] = {r_Sun_bf, r_Moon_bf};
+    const double GM_b[2] = {GM_Sun, GM_Moon};
+    Matrix pnm(4,4), dpnm(4,4);
+    for (int j = 0; j < 2; j++) {
+        const double* s = rb[j];
+        double rho = sqrt(s[0]*s[0] + s[1]*s[1] + s[2]*s[2]);
+        double lon = atan2(s[1], s[0]);
+        Legendre(3, 3, asin(s[2]/rho), pnm, dpnm);
+
+        double f = GM_b[j]/GM_Earth*(R_Earth/rho)*(R_Earth/rho);
+        for (int n = 2; n <= 3; n++) {
+            f *= R_Earth/rho;
+            for (int m = 0; m <= n; m++) {
+                double c = f*pnm(n+1,m+1)*cos(m*lon)/(2.0*n+1.0);
+                double sn = f*pnm(n+1,m+1)*sin(m*lon)/(2.0*n+1.0);
+                dC[n][m] += k_re[n][m]*c + k_im[n][m]*sn;
+                dS[n][m] += k_re[n][m]*sn - k_im[n][m]*c;
+                if (n == 2) {
+                    dC[4][m] += k_plus[m]*c;
+                    dS[4][m] += k_plus[m]*sn;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Suma la aceleración de la diferencia entre un bloque corregido y las tablas globales.
+ *
+ * Sirve para añadir las mareas a un campo estático ya evaluado (por ejemplo, `GravityGrid`).
+ *
+ * @param r Posición en el sistema inercial [m].
+ * @param E Matriz de transformación al sistema ligado a la Tierra.
+ * @param patch Bloque corregido.
+ * @param a Aceleración (entrada y salida: se suma la diferencia).
+ */
+void AccelPatch(const double* r, Matrix& E, const GravityPatch& patch, double* a){
+    if (patch.n < 2) {
+        return;
+    }
+    double a1[3], a0[3];
+    AccelHarmonicBatch(1, r, E, patch.n, patch.n, a1, &patch);
+    AccelHarmonicBatch(1, r, E, patch.n, patch.n, a0);
+    for (int i = 0; i < 3; i++) {
+        a[i] += a1[i] - a0[i];
+    }
+}
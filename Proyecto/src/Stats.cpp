@@ -0,0 +1,193 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cstdio>
+#include <cstring>
+#include "Stats.h"
+
+#ifdef PROYECTO_STATS
+#include <chrono>
+#include <mutex>
+#include <vector>
+#if defined(PROYECTO_STATS_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define STATS_USE_RDTSC
+#endif
+#endif
+
+/*%--------------------------------------------------------------------------
+%
+% Stats: Integration statistics and hot-path timers
+%
+% Every thread accumulates its counters in its own thread_local block, so
+% the instrumented code takes no lock. The blocks are registered in a list
+% and folded into a retired total when the thread exits; StatsTotal adds
+% both.
+%
+% Compiled in with -DPROYECTO_STATS (CMake option PROYECTO_STATS); the
+% STAT_* macros expand to nothing otherwise. Timers read the time stamp
+% counter with PROYECTO_STATS_RDTSC on x86 and std::chrono::steady_clock
+% otherwise; the counter frequency is calibrated against steady_clock
+% between StatsReset and StatsPrint.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file Stats.cpp
+ * @brief Contadores y temporizadores por hilo de los integradores y de `Accel`.
+ */
+
+static const char* CounterName[STAT_NCOUNTER] = {
+    "DEInteg steps", "DEInteg rejected", "DEInteg order changes", "DEInteg func calls",
+    "RKInteg steps", "RKInteg rejected", "RKInteg func calls", "Accel calls"
+};
+
+static const char* TimerName[STAT_NTIMER] = {
+    "IERS/timediff", "Frame matrices", "JPL_Eph_DE430", "AccelHarmonic", "AccelPointMass", "AccelDrag", "AccelSolrad"
+};
+
+#ifdef PROYECTO_STATS
+
+namespace {
+
+struct StatsRegistry {
+    std::mutex lock;
+    std::vector<Stats*> live;
+    Stats retired;
+    std::chrono::steady_clock::time_point t0;
+    unsigned long long c0;
+
+    StatsRegistry() : t0(std::chrono::steady_clock::now()), c0(StatsClock()) {
+        memset(&retired, 0, sizeof(Stats));
+    }
+};
+
+StatsRegistry& Registry() {
+    static StatsRegistry reg;
+    return reg;
+}
+
+struct ThreadBlock {
+    Stats s;
+
+    ThreadBlock() {
+        memset(&s, 0, sizeof(Stats));
+        StatsRegistry& reg = Registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        reg.live.push_back(&s);
+    }
+
+    ~ThreadBlock() {
+        StatsRegistry& reg = Registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        for (int i = 0; i < STAT_NCOUNTER; i++) {
+            reg.retired.count[i] += s.count[i];
+        }
+        for (int i = 0; i < STAT_NTIMER; i++) {
+            reg.retired.ticks[i] += s.ticks[i];
+        }
+        for (size_t i = 0; i < reg.live.size(); i++) {
+            if (reg.live[i] == &s) {
+                reg.live.erase(reg.live.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+}
+
+/**
+ * @brief Bloque de contadores del hilo actual.
+ */
+Stats& ThreadStats() {
+    thread_local ThreadBlock block;
+    return block.s;
+}
+
+/**
+ * @brief Lectura del reloj de los temporizadores (ciclos con RDTSC, ns en otro caso).
+ */
+unsigned long long StatsClock() {
+#ifdef STATS_USE_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#endif
+
+/**
+ * @brief Pone a cero los contadores de todos los hilos.
+ */
+void StatsReset() {
+#ifdef PROYECTO_STATS
+    StatsRegistry& reg = Registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (size_t i = 0; i < reg.live.size(); i++) {
+        memset(reg.live[i], 0, sizeof(Stats));
+    }
+    memset(&reg.retired, 0, sizeof(Stats));
+    reg.t0 = std::chrono::steady_clock::now();
+    reg.c0 = StatsClock();
+#endif
+}
+
+/**
+ * @brief Suma de los contadores de todos los hilos (vivos y terminados).
+ *
+ * @param s Totales (salida); todo a cero si la instrumentación está desactivada.
+ */
+void StatsTotal(Stats& s) {
+    memset(&s, 0, sizeof(Stats));
+#ifdef PROYECTO_STATS
+    StatsRegistry& reg = Registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    s = reg.retired;
+    for (size_t k = 0; k < reg.live.size(); k++) {
+        for (int i = 0; i < STAT_NCOUNTER; i++) {
+            s.count[i] += reg.live[k]->count[i];
+        }
+        for (int i = 0; i < STAT_NTIMER; i++) {
+            s.ticks[i] += reg.live[k]->ticks[i];
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Escribe en la salida estándar el resumen de contadores y tiempos.
+ *
+ * No escribe nada si la instrumentación está desactivada.
+ */
+void StatsPrint() {
+#ifdef PROYECTO_STATS
+    Stats s;
+    StatsTotal(s);
+
+    //% Seconds per clock tick
+    StatsRegistry& reg = Registry();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - reg.t0).count();
+    double scale = 1e-9;
+#ifdef STATS_USE_RDTSC
+    unsigned long long dc = StatsClock() - reg.c0;
+    scale = dc > 0 ? wall/dc : 0.0;
+#endif
+
+    printf("\nIntegration statistics\n");
+    for (int i = 0; i < STAT_NCOUNTER; i++) {
+        printf("%-24s%14llu\n", CounterName[i], s.count[i]);
+    }
+    printf("\nAccel timers (all threads)\n");
+    for (int i = 0; i < STAT_NTIMER; i++) {
+        double sec = s.ticks[i]*scale;
+        printf("%-24s%12.3f [s] %6.1f%%\n", TimerName[i], sec, wall > 0.0 ? 100.0*sec/wall : 0.0);
+    }
+    printf("%-24s%12.3f [s]\n", "Wall clock", wall);
+#else
+    (void) CounterName;
+    (void) TimerName;
+#endif
+}
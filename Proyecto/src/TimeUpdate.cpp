@@ -30,4 +30,16 @@
 */
 void TimeUpdate(Matrix& P,Matrix Phi, double Qdt) {
     P = Phi * P * Phi.transpose()+ Qdt;
-}
\ No newline at end of file
+}
+/**
+* @brief Actualiza la matriz de covarianza con una matriz de ruido del proceso.
+*
+* P = Phi * P * Phi^T + Qdt
+*
+* @param P Matriz de covarianza de error y propagación del estado [entrada y salida].
+* @param Phi Matriz de propagación del estado.
+* @param Qdt Matriz de covarianza del ruido del proceso integrada en el intervalo (ver `ProcessNoise`).
+*/
+void TimeUpdate(Matrix& P,Matrix Phi, Matrix Qdt) {
+    P = Phi * P * Phi.transpose() + Qdt;
+}
@@ -0,0 +1,234 @@
+//
+// Created by adboudja on 19/10/2026.
+//
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "UKF.h"
+#include "Matrix.h"
+#include "Accel.h"
+
+/*%--------------------------------------------------------------------------
+%
+% UKF: Unscented Kalman filter time and measurement updates
+%
+% The 2n+1 = 13 sigma points of the 6-dimensional state are propagated with
+% the equations of motion alone (Accel), without variational equations.
+% The sigma points are independent, so they are integrated concurrently.
+%
+% Scaled unscented transform with alpha = 1, beta = 2, kappa = 0:
+%   lambda = 0, X_0 = Y, X_i = Y +/- sqrt(n)*S(:,i), P = S*S'
+%   Wm_0 = 0, Wc_0 = 2, Wm_i = Wc_i = 1/(2n)
+%
+% Reference:
+%   S.J. Julier, J.K. Uhlmann, "Unscented filtering and nonlinear
+%   estimation", Proceedings of the IEEE 92(3), 2004.
+%
+%--------------------------------------------------------------------------*/
+/**
+ * @file UKF.cpp
+ * @brief Filtro de Kalman unscented con propagación paralela de los puntos sigma.
+ */
+
+static const int NX = 6;            // State dimension
+static const int NSIG = 2*NX+1;     // Number of sigma points
+
+/**
+ * @brief Calcula los puntos sigma y sus pesos.
+ *
+ * @param Y Estado (6).
+ * @param P Covarianza 6x6.
+ * @param X Puntos sigma (salida, 13x6 por filas).
+ * @param Wm Pesos de la media (salida, 13).
+ * @param Wc Pesos de la covarianza (salida, 13).
+ */
+void SigmaPoints(const double* Y, Matrix& P, double* X, double* Wm, double* Wc){
+    const double alpha = 1.0, beta = 2.0, kappa = 0.0;
+    double lambda = alpha*alpha*(NX+kappa) - NX;
+    double c = sqrt(NX+lambda);
+
+    //% Cholesky factor P = S*S' (semi-definite pivots are set to zero)
+    double S[NX][NX];
+    for (int j = 0; j < NX; j++) {
+        double d = P(j+1,j+1);
+        for (int k = 0; k < j; k++) {
+            d -= S[j][k]*S[j][k];
+        }
+        S[j][j] = d > 0.0 ? sqrt(d) : 0.0;
+        for (int i = j+1; i < NX; i++) {
+            double s = P(i+1,j+1);
+            for (int k = 0; k < j; k++) {
+                s -= S[i][k]*S[j][k];
+            }
+            S[i][j] = S[j][j] > 0.0 ? s/S[j][j] : 0.0;
+        }
+        for (int i = 0; i < j; i++) {
+            S[i][j] = 0.0;
+        }
+    }
+
+    for (int i = 0; i < NX; i++) {
+        X[i] = Y[i];
+    }
+    for (int j = 0; j < NX; j++) {
+        for (int i = 0; i < NX; i++) {
+            X[NX*(1+j)+i] = Y[i] + c*S[i][j];
+            X[NX*(1+NX+j)+i] = Y[i] - c*S[i][j];
+        }
+    }
+
+    Wm[0] = lambda/(NX+lambda);
+    Wc[0] = Wm[0] + (1.0 - alpha*alpha + beta);
+    for (int l = 1; l < NSIG; l++) {
+        Wm[l] = 1.0/(2.0*(NX+lambda));
+        Wc[l] = Wm[l];
+    }
+}
+
+/**
+ * @brief Propaga un bloque de puntos sigma.
+ */
+static void PropagateBlock(double* X, int lo, int hi, double dt, AccelParam param, Integrator integ){
+    auto f = [&param](double x, const double* Y, double* dY) {
+        Accel(x, Y, dY, param);
+    };
+    for (int l = lo; l < hi; l++) {
+        Integrate(integ,f,0,dt,1e-13,1e-6,NX,&X[NX*l]);
+    }
+}
+
+/**
+ * @brief Actualización temporal del filtro de Kalman unscented.
+ *
+ * Los puntos sigma se integran con `Accel` repartidos entre hilos; cada hilo recibe
+ * una copia de la época y el modelo de fuerzas.
+ *
+ * @param Y Estado (entrada y salida).
+ * @param P Covarianza (entrada y salida).
+ * @param dt Intervalo de propagación [s].
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @param nthreads Número de hilos (0: número de núcleos disponibles).
+ * @param integ Integrador de los puntos sigma.
+ */
+void UKFTimeUpdate(double* Y, Matrix& P, double dt, const AccelParam& p, int nthreads, Integrator integ){
+    double X[NX*NSIG], Wm[NSIG], Wc[NSIG];
+
+    SigmaPoints(Y, P, X, Wm, Wc);
+    AccelParam param = p;
+
+    if (nthreads <= 0) {
+        nthreads = (int) std::thread::hardware_concurrency();
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+    if (nthreads > NSIG) {
+        nthreads = NSIG;
+    }
+
+    //% Parallel propagation of the sigma points
+    std::vector<std::thread> workers;
+    int block = (NSIG + nthreads - 1)/nthreads;
+    for (int t = 1; t < nthreads; t++) {
+        int lo = t*block;
+        int hi = lo + block < NSIG ? lo + block : NSIG;
+        if (lo < hi) {
+            workers.push_back(std::thread(PropagateBlock, X, lo, hi, dt, param, integ));
+        }
+    }
+    PropagateBlock(X, 0, block < NSIG ? block : NSIG, dt, param, integ);
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    //% Predicted mean and covariance
+    for (int i = 0; i < NX; i++) {
+        Y[i] = 0.0;
+        for (int l = 0; l < NSIG; l++) {
+            Y[i] += Wm[l]*X[NX*l+i];
+        }
+    }
+    for (int i = 0; i < NX; i++) {
+        for (int j = 0; j < NX; j++) {
+            double s = 0.0;
+            for (int l = 0; l < NSIG; l++) {
+                s += Wc[l]*(X[NX*l+i]-Y[i])*(X[NX*l+j]-Y[j]);
+            }
+            P(i+1,j+1) = s;
+        }
+    }
+}
+
+/**
+ * @brief Actualización de medida del filtro de Kalman unscented.
+ *
+ * @param Y Estado (entrada y salida).
+ * @param P Covarianza (entrada y salida).
+ * @param model Modelo de observación.
+ * @param U Matriz de rotación de la Tierra en la época de las medidas.
+ * @param obs Observaciones de la época.
+ * @param nz Número de observaciones.
+ */
+void UKFMeasUpdate(double* Y, Matrix& P, MeasModel& model, Matrix& U, const Observation* obs, int nz){
+    double X[NX*NSIG], Wm[NSIG], Wc[NSIG];
+    MeasPrediction pred;
+
+    SigmaPoints(Y, P, X, Wm, Wc);
+
+    //% Predicted measurements of every sigma point
+    std::vector<double> Z(NSIG*nz), z(nz, 0.0);
+    for (int l = 0; l < NSIG; l++) {
+        int last = -1;
+        for (int m = 0; m < nz; m++) {
+            if (obs[m].station != last) {
+                model.predict(obs[m].station, U, &X[NX*l], pred);
+                last = obs[m].station;
+            }
+            Z[nz*l+m] = pred.value[obs[m].type];
+        }
+    }
+    for (int m = 0; m < nz; m++) {
+        //% Azimuths are averaged as deviations from the central sigma point
+        double ref = Z[m];
+        for (int l = 0; l < NSIG; l++) {
+            double dz = Z[nz*l+m] - ref;
+            if (obs[m].type == MEAS_AZIMUTH) {
+                dz = atan2(sin(dz), cos(dz));
+                Z[nz*l+m] = ref + dz;
+            }
+            z[m] += Wm[l]*Z[nz*l+m];
+        }
+    }
+
+    //% Innovation and cross covariances
+    Matrix Pzz(nz,nz), Pxz(NX,nz);
+    for (int a = 0; a < nz; a++) {
+        for (int l = 0; l < NSIG; l++) {
+            double dza = Z[nz*l+a] - z[a];
+            for (int b = 0; b < nz; b++) {
+                Pzz(a+1,b+1) += Wc[l]*dza*(Z[nz*l+b] - z[b]);
+            }
+            for (int i = 0; i < NX; i++) {
+                Pxz(i+1,a+1) += Wc[l]*(X[NX*l+i] - Y[i])*dza;
+            }
+        }
+        double sigma = model.getStation(obs[a].station).sigma[obs[a].type];
+        Pzz(a+1,a+1) += sigma*sigma;
+    }
+
+    //% Kalman gain, state and covariance update
+    Matrix K = Pxz*Pzz.inverse();
+    for (int i = 0; i < NX; i++) {
+        for (int m = 0; m < nz; m++) {
+            double dz = obs[m].value - z[m];
+            if (obs[m].type == MEAS_AZIMUTH) {
+                dz = atan2(sin(dz), cos(dz));
+            }
+            Y[i] += K(i+1,m+1)*dz;
+        }
+    }
+    Matrix KPzz = K*Pzz;
+    Matrix Kt = K.transpose();
+    P = P - KPzz*Kt;
+}
@@ -3,6 +3,8 @@
 //
 
 #include "VarEqn.h"
+#include <cmath>
+#include "Accel.h"
 #include "global.h"
 #include "IERS.h"
 #include "timediff.h"
@@ -14,6 +16,10 @@
 #include "AccelHarmonic.h"
 #include "G_AccelHarmonic.h"
 #include "auxFunc.h"
+#include "RKInteg.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 /*%------------------------------------------------------------------------------
 %
@@ -34,6 +40,27 @@
 % Last modified:   2015/08/12   M. Mahooti
 %
 %------------------------------------------------------------------------------*/
+/**
+ * @brief Matriz de transformación al sistema ligado a la Tierra usada por VarEqn.
+ *
+ * @param x Tiempo desde el epoch en segundos.
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @return Matrix Matriz de transformación E.
+ */
+Matrix VarEqnFrame(double x, const AccelParam& p){
+
+double x_pole,y_pole,UT1_UTC,dpsi,LOD,deps,dx_pole,dy_pole,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC;
+
+IERS(*global::eopdate,p.Mjd_UTC,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
+timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
+double Mjd_UT1 = p.Mjd_TT + (UT1_UTC-TT_UTC)/86400;
+
+Matrix P = PrecMatrix(MJD_J2000,p.Mjd_TT + x/86400);
+Matrix N = NutMatrix(p.Mjd_TT + x/86400);
+Matrix T = N * P;
+return PoleMatrix(x_pole,y_pole) * GHAMatrix(Mjd_UT1) * T;
+}
+
 /**
  * @file VarEqn.cpp
  * @brief Implementación de las ecuaciones variacionales.
@@ -44,27 +71,18 @@
  * @param x Tiempo desde el epoch en segundos.
  * @param yPhi Vector de dimensión (6+36) que comprende el vector de estado (y) y la
  * matriz de transición de estado (Phi) en orden de almacenamiento por columnas.
- * @return Puntero a un array de tamaño 42 que representa la derivada de yPhi.
+ * @param yPhip Derivada de yPhi (salida, 42).
+ * @param p Época y modelo de fuerzas de la propagación.
  */
-double* VarEqn(double x,double* yPhi){
-
-double x_pole,y_pole,UT1_UTC,dpsi,LOD,deps,dx_pole,dy_pole,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC;
-
-IERS(*global::eopdate,global::Mjd_UTC,'l',x_pole,y_pole,UT1_UTC,LOD,dpsi,deps,dx_pole,dy_pole,TAI_UTC);
-timediff(UT1_UTC,TAI_UTC,UT1_TAI,UTC_GPS,UT1_GPS,TT_UTC,GPS_UTC);
-double Mjd_UT1 = global::Mjd_TT + (UT1_UTC-TT_UTC)/86400;
+void VarEqn(double x, const double* yPhi, double* yPhip, const AccelParam& p){
 
 //% Transformation matrix
-Matrix P = PrecMatrix(MJD_J2000,global::Mjd_TT + x/86400);
-Matrix N = NutMatrix(global::Mjd_TT + x/86400);
-Matrix T = N * P;
-Matrix E = PoleMatrix(x_pole,y_pole) * GHAMatrix(Mjd_UT1) * T;
+Matrix E = VarEqnFrame(x, p);
 
 //% State vector components
 
-int s;
-    double* r = extractSubarray(yPhi,0,2,s);
-    double* v = extractSubarray(yPhi,3,5,s);
+    double r[3] = {yPhi[0], yPhi[1], yPhi[2]};
+    double v[3] = {yPhi[3], yPhi[4], yPhi[5]};
 
     Matrix Phi(6,6);
 
@@ -76,15 +94,16 @@ for(int j=0;j<6;j++){
     }
 
 }
-    Phi.print();
 
 
 //% Acceleration and gradient
-double* a = AccelHarmonic ( r, E, global::n, global::m );
-Matrix G = G_AccelHarmonic ( r, E, global::n, global::m );
+int n, m;
+GravityDegree(p, sqrt(r[0]*r[0]+r[1]*r[1]+r[2]*r[2]), n, m);
+double a[3];
+AccelHarmonic ( r, E, n, m, a );
+Matrix G = G_AccelHarmonic ( r, E, n, m );
 
 //% Time derivative of state transition matrix
-auto* yPhip = new double[42];
 Matrix dfdy(6,6);
 
 for(int i=0;i<3;i++){
@@ -114,12 +133,185 @@ for(int i=0;i<3;i++){
 }
                 //% dv/dt(i)
 
-for(int i=0;i<5;i++){
-    for(int j=0;j<5;j++){
-        yPhip[6*j+i] = Phip(i+1,j+1);     //% dPhi/dt(i,j)
+for(int i=0;i<6;i++){
+    for(int j=0;j<6;j++){
+        yPhip[6*(j+1)+i] = Phip(i+1,j+1);     //% dPhi/dt(i,j)
     }
 
 }
 
+}
+
+/**
+ * @brief Ecuaciones variacionales con la época y el modelo de fuerzas globales.
+ *
+ * @param x Tiempo desde el epoch en segundos.
+ * @param yPhi Vector de estado y matriz de transición (42).
+ * @return Puntero a un array de tamaño 42 (memoria reservada con new[]) con la derivada de yPhi.
+ */
+double* VarEqn(double x,double* yPhi){
+    auto* yPhip = new double[42];
+    VarEqn(x, yPhi, yPhip, GlobalAccelParam());
     return yPhip;
-}
\ No newline at end of file
+}
+/**
+ * @brief Gradiente de la aceleración del campo gravitatorio en el sistema inercial.
+ *
+ * Es el bloque da/dr de las ecuaciones variacionales: mismo sistema de referencia
+ * (`VarEqnFrame`) y mismo grado (`GravityDegree`) que `VarEqn`.
+ *
+ * @param x Tiempo desde el epoch en segundos.
+ * @param r Posición inercial [m] (3).
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @param G Gradiente da/dr por filas (salida, 9).
+ */
+void VarEqnGradient(double x, const double* r, const AccelParam& p, double* G){
+    Matrix E = VarEqnFrame(x, p);
+    double rr[3] = {r[0], r[1], r[2]};
+    int n, m;
+    GravityDegree(p, sqrt(rr[0]*rr[0] + rr[1]*rr[1] + rr[2]*rr[2]), n, m);
+    Matrix Gm = G_AccelHarmonic(rr, E, n, m);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            G[3*i+j] = Gm(i+1,j+1);
+        }
+    }
+}
+
+static const int GSUB = 2;      // Gradient samples per accepted step of the reference
+
+/**
+ * @brief Integra un grupo de columnas de sensibilidad frente a la trayectoria de referencia.
+ *
+ * El gradiente se interpola en los nodos de la referencia, por lo que cada etapa solo
+ * cuesta la interpolación (y el término forzado, si lo hay).
+ */
+static void ColumnBlock(const DenseOrbit* ref, double t, double tout, int c0, int ncol, double* S,
+                        const SensitivityForcing* forcing, double relerr, double abserr){
+    auto f = [ref, c0, ncol, forcing](double x, const double* s, double* ds) {
+        double G[9], Y[6], da[3];
+        ref->evalGradient(x, G);
+        if (forcing != nullptr) {
+            ref->eval(x, Y);
+        }
+        for (int c = 0; c < ncol; c++) {
+            const double* sc = &s[6*c];
+            da[0] = da[1] = da[2] = 0.0;
+            if (forcing != nullptr) {
+                forcing->dadp(x, Y, c0 + c + 1, da);
+            }
+            for (int i = 0; i < 3; i++) {
+                ds[6*c+i] = sc[i+3];
+                ds[6*c+i+3] = G[3*i]*sc[0] + G[3*i+1]*sc[1] + G[3*i+2]*sc[2] + da[i];
+            }
+        }
+    };
+    RKInteg(f,t,tout,relerr,abserr,6*ncol,S,6);
+}
+
+/**
+ * @brief Propaga columnas de la matriz de transición o de sensibilidad.
+ *
+ * Cada columna s cumple s' = [s_v; G(t)*s_r + da/dp], con el gradiente G interpolado en los
+ * nodos de la trayectoria de referencia (`DenseOrbit::evalGradient`), de modo que el campo
+ * gravitatorio se evalúa una sola vez por nodo y no en cada etapa de cada columna. El término
+ * da/dp es nulo para las columnas de la matriz de transición y lo da `forcing` para las de
+ * parámetros. Las columnas son independientes y pueden repartirse entre hilos, lo que solo
+ * compensa con muchas columnas o un término forzado costoso.
+ *
+ * @param ref Trayectoria de referencia con salida densa y gradiente en sus nodos en [t, tout].
+ * @param t Instante inicial [s].
+ * @param tout Instante final [s].
+ * @param S Columnas (6 x ncol) en t (entrada) y en tout (salida).
+ * @param forcing Término forzado da/dp(t, Y, columna desde 1) (nulo: todas las columnas sin él).
+ * @param nthreads Número de hilos (0: número de núcleos disponibles).
+ * @param relerr Tolerancia relativa.
+ * @param abserr Tolerancia absoluta.
+ * @throws std::out_of_range Si algún nodo de la referencia no tiene gradiente.
+ */
+void VarEqnColumns(const DenseOrbit& ref, double t, double tout, Matrix& S,
+                   const SensitivityForcing* forcing, int nthreads, double relerr, double abserr){
+    int ncol = S.getCol();
+    if (ref.getNodes() < 2 or ref.getGradients() < 2) {
+        throw std::out_of_range("VarEqnColumns: reference without gradient samples");
+    }
+    if (nthreads <= 0) {
+        nthreads = (int) std::thread::hardware_concurrency();
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+    if (nthreads > ncol) {
+        nthreads = ncol;
+    }
+
+    std::vector<double> cols(6*ncol);
+    for (int c = 0; c < ncol; c++) {
+        for (int i = 0; i < 6; i++) {
+            cols[6*c+i] = S(i+1,c+1);
+        }
+    }
+
+    //% Contiguous groups of columns, one per thread
+    std::vector<std::thread> workers;
+    int block = (ncol + nthreads - 1)/nthreads;
+    for (int c0 = block; c0 < ncol; c0 += block) {
+        int nc = c0 + block < ncol ? block : ncol - c0;
+        workers.push_back(std::thread(ColumnBlock, &ref, t, tout, c0, nc, &cols[6*c0], forcing, relerr, abserr));
+    }
+    ColumnBlock(&ref, t, tout, 0, block < ncol ? block : ncol, cols.data(), forcing, relerr, abserr);
+    for (size_t k = 0; k < workers.size(); k++) {
+        workers[k].join();
+    }
+
+    for (int c = 0; c < ncol; c++) {
+        for (int i = 0; i < 6; i++) {
+            S(i+1,c+1) = cols[6*c+i];
+        }
+    }
+}
+
+/**
+ * @brief Propaga el estado y la matriz de transición sobre una trayectoria de referencia.
+ *
+ * La trayectoria se integra una sola vez con `Accel` guardando la salida densa y GSUB muestras
+ * del gradiente del campo gravitatorio por paso aceptado (`VarEqnGradient`), y a continuación
+ * las seis columnas de la matriz de transición se integran con `VarEqnColumns`. Frente a
+ * integrar `VarEqn` (42 ecuaciones) y `Accel` por separado, el gradiente se evalúa dos veces
+ * por paso en lugar de en cada una de sus 12 etapas (caso STM/PropagateSTM del banco de
+ * pruebas). La linealización es en torno a la trayectoria de `Accel`, que sigue la rotación de
+ * la Tierra, y no en torno a la de `VarEqn`.
+ *
+ * @param t Instante inicial [s].
+ * @param tout Instante final [s].
+ * @param Y Estado en t (entrada) y en tout (salida).
+ * @param Phi Matriz de transición de t a tout (salida, 6x6).
+ * @param p Época y modelo de fuerzas de la propagación.
+ * @param nthreads Número de hilos de las columnas (0: número de núcleos disponibles).
+ */
+void PropagateSTM(double t, double tout, double* Y, Matrix& Phi, const AccelParam& p, int nthreads){
+    Phi = Matrix::identity(6);
+    if (tout == t) {
+        return;
+    }
+    DenseOrbit ref;
+    double t_last = t;
+    RKInteg([&p](double x, const double* y, double* dy) { Accel(x, y, dy, p); },
+            t,tout,1e-13,1e-6,6,Y,0,
+            [&ref, &p, &t_last](double x, const double* y, const double* dy) {
+                ref.add(x, y, dy);
+                if (ref.getNodes() < 2) {
+                    return;
+                }
+                //% Gradient samples on the step just accepted (and at its start for the first one)
+                double G[9], Yk[6];
+                for (int k = ref.getNodes() == 2 ? 0 : 1; k <= GSUB; k++) {
+                    double tk = k == GSUB ? x : t_last + k*(x - t_last)/GSUB;
+                    ref.eval(tk, Yk);
+                    VarEqnGradient(tk, Yk, p, G);
+                    ref.addGradient(tk, G);
+                }
+                t_last = x;
+            });
+    VarEqnColumns(ref, t, tout, Phi, nullptr, nthreads, 1e-13, 1e-6);
+}
@@ -4,6 +4,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 #include "global.h"
 /**
  * @file global.h
@@ -60,6 +62,10 @@ int global::moon;
      * @brief Indicador para incluir el efecto de la influencia de los planetas.
      */
 int global::planets;
+/**
+     * @brief Indicador para incluir la corrección relativista (Schwarzschild).
+     */
+int global::relativity;
 /**
      * @brief Carga los datos de los parámetros EOP desde un archivo.
      */
@@ -82,24 +88,110 @@ void global::eop19620101() {
     }
     fclose(fid);
 }
+/*%--------------------------------------------------------------------------
+%
+% GGM03S binary snapshot
+%
+%   char[8]   "GGM03S" + format version (2 NUL padded bytes, version 1)
+%   int32     maximum degree N stored
+%   int32     0 (reserved)
+%   double    1.0 (byte order check)
+%   double[2] (C,S) for n = 0..N, m = 0..n, ordered by degree
+%
+% The coefficients up to degree n are the first (n+1)(n+2)/2 pairs, so a
+% truncated load reads only that prefix of the file.
+%
+%--------------------------------------------------------------------------*/
+static const char GGM03S_magic[8] = {'G','G','M','0','3','S','\0','\1'};
+
 /**
      * @brief Carga los coeficientes de la expansión de armónicos GGM03S desde un archivo.
      */
 void global::GGM03S(){
-        global::Cnm = new Matrix(181,181);
-        global::Snm = new Matrix(181,181);
-        Matrix *temp = new Matrix(6,1);
-    FILE *fid =fopen("../data/GGM03S.txt","r");
+    global::GGM03S(180);
+}
+/**
+     * @brief Carga los coeficientes GGM03S hasta el grado y orden nmax.
+     *
+     * Se lee la instantánea binaria `../data/GGM03S.bin` (solo los coeficientes necesarios) y, si
+     * no existe o no es válida, el fichero de texto hasta el grado nmax. Las matrices Cnm y Snm
+     * son de (nmax+1)x(nmax+1): los modelos de fuerzas no pueden usar un grado mayor. Las tablas
+     * cargadas antes se liberan, así que no deben quedar referencias a ellas.
+     *
+     * @param nmax Grado máximo (0..180).
+     */
+void global::GGM03S(int nmax){
+    if (nmax < 0 || nmax > 180) {
+        printf("Error");
+        exit(EXIT_FAILURE);
+    }
+    delete global::Cnm;
+    delete global::Snm;
+    global::Cnm = new Matrix(nmax+1,nmax+1);
+    global::Snm = new Matrix(nmax+1,nmax+1);
+
+    //% Binary snapshot
+    FILE *fid =fopen("../data/GGM03S.bin","rb");
+    if (fid != nullptr) {
+        char magic[8];
+        int header[2];
+        double one;
+        bool ok = fread(magic,1,8,fid) == 8 && fread(header,sizeof(int),2,fid) == 2 &&
+                  fread(&one,sizeof(double),1,fid) == 1 &&
+                  memcmp(magic,GGM03S_magic,8) == 0 && header[0] >= nmax && one == 1.0;
+        int np = (nmax+1)*(nmax+2)/2;
+        std::vector<double> cs(2*np);
+        ok = ok && (int) fread(cs.data(),sizeof(double),2*np,fid) == 2*np;
+        fclose(fid);
+        if (ok) {
+            int k = 0;
+            for(int n=0;n<=nmax;n++){
+                for(int m=0;m<=n;m++){
+                    (*global::Cnm)(n+1,m+1)=cs[k++];
+                    (*global::Snm)(n+1,m+1)=cs[k++];
+                }
+            }
+            return;
+        }
+    }
+
+    fid =fopen("../data/GGM03S.txt","r");
 
     if(fid== nullptr){
         printf("Error");
         exit(EXIT_FAILURE);
     }
-    for(int n=0;n<=180;n++){
+    double temp[6];
+    for(int n=0;n<=nmax;n++){
         for(int m=0;m<=n;m++){
-            fscanf(fid,"%lf %lf %lf %lf %lf %lf",&(*temp)(1,1),&(*temp)(2,1),&(*temp)(3,1),&(*temp)(4,1),&(*temp)(5,1),&(*temp)(6,1));
-            (*global::Cnm)(n+1,m+1)=(*temp)(3,1);
-            (*global::Snm)(n+1,m+1)=(*temp)(4,1);
+            fscanf(fid,"%lf %lf %lf %lf %lf %lf",&temp[0],&temp[1],&temp[2],&temp[3],&temp[4],&temp[5]);
+            (*global::Cnm)(n+1,m+1)=temp[2];
+            (*global::Snm)(n+1,m+1)=temp[3];
+        }
+    }
+    fclose(fid);
+}
+/**
+     * @brief Escribe la instantánea binaria de los coeficientes GGM03S cargados.
+     *
+     * @param path Fichero de salida (normalmente `../data/GGM03S.bin`).
+     */
+void global::GGM03S_bin(const char* path){
+    FILE *fid =fopen(path,"wb");
+
+    if(fid== nullptr){
+        printf("Error");
+        exit(EXIT_FAILURE);
+    }
+    int header[2] = {global::Cnm->getRows()-1, 0};
+    double one = 1.0;
+    fwrite(GGM03S_magic,1,8,fid);
+    fwrite(header,sizeof(int),2,fid);
+    fwrite(&one,sizeof(double),1,fid);
+    for(int n=0;n<=header[0];n++){
+        for(int m=0;m<=n;m++){
+            double cs[2] = {(*global::Cnm)(n+1,m+1), (*global::Snm)(n+1,m+1)};
+            fwrite(cs,sizeof(double),2,fid);
         }
     }
     fclose(fid);
@@ -136,7 +228,7 @@ void global::AuxParam(){
 
     global::Mjd_TT=0;
     global::m=0;
-    global::n=0;
+    global::relativity=0;
     global::n=0;
     global::n=0;
     global::n=0;